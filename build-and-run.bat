@@ -1,7 +1,7 @@
 @echo off
 echo Building C++ project...
 if not exist build mkdir build
-g++ -I include -std=c++17 src/main.cpp src/ArrayBasedCollection.cpp src/CSVParser.cpp src/Transaction.cpp src/LinkedListBasedCollection.cpp -o build/MyCppProject.exe
+g++ -I include -std=c++17 -pthread src/main.cpp src/ArrayBasedCollection.cpp src/CSVParser.cpp src/Transaction.cpp src/LinkedListBasedCollection.cpp src/MappedFile.cpp src/CSVTokenizer.cpp src/DataStructureComparator.cpp src/TransactionBuffer.cpp src/ColumnarSnapshot.cpp src/StringDictionary.cpp src/CompactId.cpp src/TransactionTable.cpp src/Arena.cpp src/Amount.cpp src/HotRecord.cpp src/TopKByChannel.cpp -o build/MyCppProject.exe
 if %errorlevel% == 0 (
     echo Build successful! Running program...
     echo.
@@ -10,12 +10,24 @@ fi
 
 # Compile all source files
 echo "Compiling source files..."
-g++ -I include -std=c++17 \
+g++ -I include -std=c++17 -pthread \
     src/main.cpp \
     src/ArrayBasedCollection.cpp \
     src/CSVParser.cpp \
     src/Transaction.cpp \
     src/LinkedListBasedCollection.cpp \
+    src/MappedFile.cpp \
+    src/CSVTokenizer.cpp \
+    src/DataStructureComparator.cpp \
+    src/TransactionBuffer.cpp \
+    src/ColumnarSnapshot.cpp \
+    src/StringDictionary.cpp \
+    src/CompactId.cpp \
+    src/TransactionTable.cpp \
+    src/Arena.cpp \
+    src/Amount.cpp \
+    src/HotRecord.cpp \
+    src/TopKByChannel.cpp \
     -o build/MyCppProject.exe
 
 if [ $? -eq 0 ]; then
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Money as a whole number of millionths. Parsed straight from the decimal text, so "0.10" is
+// exactly 100000 and sums never drift; comparisons and sort keys are plain integer compares.
+// Six decimals keep every digit of the source amounts, so values that differ in the CSV never
+// tie here and toDouble() returns the same double stod would have. Converted back to decimal
+// only for output.
+class Amount
+{
+private:
+    int64_t micros = 0;
+
+public:
+    static constexpr int64_t MICROS_PER_UNIT = 1000000;
+
+    Amount() = default;
+    static Amount fromMicros(int64_t micros);
+    // Nearest millionth of a floating-point value, for callers that still hold doubles
+    static Amount fromDouble(double value);
+
+    // Reads a leading decimal number like stod does ("12.5", "+3", "1.2e3", "125x" -> 125);
+    // digits past the sixth decimal are rounded half away from zero and overflow saturates.
+    // Returns false when the text does not start with a number.
+    static bool parse(string_view text, Amount &value);
+
+    int64_t getMicros() const { return micros; }
+    double toDouble() const { return static_cast<double>(micros) / MICROS_PER_UNIT; }
+
+    // Decimal text with at least two decimals and no trailing zeros past them, e.g. "1234.50",
+    // "212.779792"
+    void appendTo(string &out) const;
+    string toString() const;
+
+    // Exact total of a contiguous micros column; a plain loop the compiler vectorizes
+    static int64_t sumMicros(const int64_t values[], long long count);
+
+    bool operator==(const Amount &other) const { return micros == other.micros; }
+    bool operator!=(const Amount &other) const { return micros != other.micros; }
+    bool operator<(const Amount &other) const { return micros < other.micros; }
+    bool operator>(const Amount &other) const { return micros > other.micros; }
+    bool operator<=(const Amount &other) const { return micros <= other.micros; }
+    bool operator>=(const Amount &other) const { return micros >= other.micros; }
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+using namespace std;
+
+// Bump allocator: hands out pieces of large slabs and frees everything at once. Nothing is
+// freed individually, so many small strings cost one allocation per slab instead of one each
+// and releasing them is a walk over the slabs, not over the strings. Not thread-safe.
+class Arena
+{
+private:
+    struct Slab
+    {
+        char *data;
+        size_t size;
+        Slab *previous;
+    };
+
+    size_t slabSize;
+    Slab *current = nullptr;
+    size_t used = 0;          // Bytes taken from the current slab
+    size_t bytesReserved = 0;
+
+    void addSlab(size_t minimumSize);
+
+public:
+    static const size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+
+    explicit Arena(size_t slabSize = DEFAULT_SLAB_SIZE) : slabSize(slabSize) {}
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    char *allocate(size_t bytes, size_t alignment = 1);
+    // Copies text into the arena; the view stays valid until reset() or destruction
+    string_view copy(string_view text);
+    void reset();
+
+    size_t getBytesReserved() const { return bytesReserved; }
+};
@@ -3,20 +3,87 @@
 #include <chrono>
 using namespace std;
 #include "../include/Transaction.hpp"
+#include "../include/TransactionTable.hpp"
+#include "../include/HotRecord.hpp"
+#include "../include/TopKByChannel.hpp"
 
 // declartion of ArrayBasedCollection class
 class ArrayBasedCollection
 {
+public:
+    enum class SortMode
+    {
+        IN_PLACE,   // Reorders the Transaction array by channel; groups are sorted as key arrays
+        PERMUTATION, // Leaves the array untouched and sorts row indices by the full key
+        TOP_K,       // Leaves the array untouched and keeps only the displayed rows per channel
+        BUCKETED     // Like IN_PLACE, with an O(n) counting-sort partition by channel and the
+                     // per-channel sorts run in parallel, one bucket per task
+    };
+
+    // Rows shown (and kept in TOP_K mode) per payment channel
+    static constexpr int DISPLAY_LIMIT = 10;
+
+    // Algorithm behind every sort of a run; both give the same stable order
+    enum class SortEngine
+    {
+        MERGE,          // Comparison merge sort, O(n log n)
+        RADIX,          // LSD radix sort on packed 64-bit keys, O(n)
+        PARALLEL_MERGE  // Merge sort split across threadCount threads
+    };
+
 private:
     Transaction *transactions;
     int numTransactions;
     string searchKey;
+    SortMode sortMode = SortMode::IN_PLACE;
+    SortEngine sortEngine = SortEngine::MERGE;
+    int threadCount = 0; // PARALLEL_MERGE workers; 0 = all cores
+
+    // One payment channel's rows after partitionByPaymentChannel
+    struct ChannelSpan
+    {
+        uint16_t channelCode;
+        int start;      // First row of the channel in the partitioned array
+        int end;        // One past its last row
+        int matchCount; // Rows of the search type, their sorted keys at hot[start]
+    };
+
+    // Permutation mode result: order[k] is the row at sorted position k (matching rows only)
+    uint32_t *order = nullptr;
+    int orderSize = 0;
 
-    void mergeSortByPaymentChannel(Transaction arr[], int left, int right);
-    void mergeByPaymentChannel(Transaction arr[], int left, int mid, int right);
-    void mergeSortByAmountThenLocation(Transaction arr[], int left, int right);
-    void mergeByAmountThenLocation(Transaction arr[], int left, int mid, int right);
-    int searchbyTransactionType(Transaction arr[], int start, int end, string &searchKey, Transaction *group);
+    // Sorts move 16-byte HotRecords; the Transaction rows are reordered once at the end, in
+    // place. hot and scratch are n-record workspaces; hot ends as the keys of the sorted arr.
+    void sortByPaymentChannel(Transaction arr[], int numTransactions, HotRecord hot[], HotRecord scratch[]);
+    // Stable sorts of count records with the selected engine; scratch must hold count records.
+    // The merge engine alternates between scratch and arr and performs no further allocation.
+    void sortRecordsByPaymentChannel(HotRecord arr[], HotRecord scratch[], int count);
+    void sortRecordsByAmountThenLocation(HotRecord arr[], HotRecord scratch[], int count);
+    // Collects the keys of matching rows in [start, end); their row fields index arr. group
+    // may be the slice of the shared key buffer at start, since it never writes past a read.
+    int searchbyTransactionType(Transaction arr[], int start, int end, string &searchKey, HotRecord *group);
+    // Permutation mode: collects the matching rows of arr and sorts them by channel, amount
+    // (highest first) and location in one pass. Leaves the sorted keys in hot and their rows
+    // in order; returns how many rows matched.
+    int buildPermutation(const Transaction arr[], int numTransactions, const string &searchKey, HotRecord hot[],
+                         chrono::milliseconds &searchElapsed, chrono::milliseconds &sortElapsed);
+    // Stable counting-sort partition of arr by channel: one histogram pass and one scatter.
+    // Writes one span per channel present, alphabetically; spans needs room for every
+    // channel in the dictionary. hot and scratch are n-record workspaces, as for
+    // sortByPaymentChannel. Returns the number of spans.
+    int partitionByPaymentChannel(Transaction arr[], int numTransactions, ChannelSpan spans[], HotRecord hot[], HotRecord scratch[]);
+    // BUCKETED mode: collects each span's matching keys at hot[start], then sorts the spans by
+    // amount and location independently on up to threadCount threads
+    void searchBuckets(const Transaction arr[], ChannelSpan spans[], int spanCount, const string &searchKey, HotRecord hot[]);
+    void sortBuckets(ChannelSpan spans[], int spanCount, HotRecord hot[], HotRecord scratch[]);
+    // TOP_K mode: one pass offering every matching row to top
+    void selectTopK(const Transaction arr[], int numTransactions, const string &searchKey, TopKByChannel &top);
+    static void printChannelHeader(uint16_t channelCode);
+    static void printRow(const Transaction &transaction);
+
+    // Column-store backend: sorts row indices, reading only the columns each key needs
+    void mergeSortIndicesByPaymentChannel(const TransactionTable &table, int indices[], int scratch[], int left, int right);
+    void mergeSortIndicesByAmountThenLocation(const TransactionTable &table, int indices[], int scratch[], int left, int right);
 
 public:
     // Timing metrics for algorithm performance
@@ -27,11 +94,29 @@ public:
 
     ~ArrayBasedCollection();
 
+    ArrayBasedCollection(const ArrayBasedCollection &) = delete;
+    ArrayBasedCollection &operator=(const ArrayBasedCollection &) = delete;
+
+    void setSortMode(SortMode mode) { sortMode = mode; }
+    SortMode getSortMode() const { return sortMode; }
+    void setSortEngine(SortEngine engine) { sortEngine = engine; }
+    SortEngine getSortEngine() const { return sortEngine; }
+    void setThreadCount(int threads) { threadCount = threads; }
+    int getThreadCount() const { return threadCount; }
+
     void printGroupedByPaymentChannel(Transaction arr[], int numTransactions, string &searchKey);
 
     void processSilently(Transaction arr[], int numTransactions, string &searchKey);
 
+    // Same work as processSilently, run against a TransactionTable
+    void processTableSilently(const TransactionTable &table, string &searchKey);
+
     // Getters for performance metrics
     chrono::milliseconds getSearchTime() const { return searchTime; }
     chrono::milliseconds getSortTime() const { return sortTime; }
+
+    // Sorted row order from the last permutation-mode run, or nullptr in IN_PLACE mode.
+    // Valid until the next run or destruction.
+    const uint32_t *getOrder() const { return order; }
+    int getOrderSize() const { return orderSize; }
 };
@@ -3,7 +3,14 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string_view>
+#include <limits>
 #include "Transaction.hpp"
+#include "MappedFile.hpp"
+#include "TransactionBuffer.hpp"
+#include "TransactionTable.hpp"
+#include "TopKByChannel.hpp"
+#include "ColumnarSnapshot.hpp"
 
 using namespace std;
 
@@ -19,6 +26,54 @@ public:
         MALFORMED         // Insufficient columns or structure issues
     };
 
+    // Per-category row counts, kept identically by the serial and parallel paths
+    struct ParseStats
+    {
+        long long success = 0;
+        long long parseErrors = 0;
+        long long validationErrors = 0;
+        long long malformed = 0;
+        long long filteredOut = 0; // Rejected by the filter before validation
+
+        void record(ParseResult result);
+        void merge(const ParseStats &other);
+        long long rowsExamined() const { return success + parseErrors + validationErrors + malformed; }
+    };
+
+    // Column projection bits: only requested columns are trimmed, copied and validated
+    enum ColumnMask : unsigned
+    {
+        COLUMN_TRANSACTION_ID = 1u << 0,
+        COLUMN_SENDER_ACCOUNT = 1u << 1,
+        COLUMN_RECEIVER_ACCOUNT = 1u << 2,
+        COLUMN_AMOUNT = 1u << 3,
+        COLUMN_TRANSACTION_TYPE = 1u << 4,
+        COLUMN_LOCATION = 1u << 5,
+        COLUMN_IS_FRAUD = 1u << 6,
+        COLUMN_PAYMENT_CHANNEL = 1u << 7,
+        ALL_COLUMNS = (1u << 8) - 1
+    };
+
+    // Row predicate evaluated on the raw field bytes, before validation and materialization
+    struct TransactionFilter
+    {
+        enum class FraudFlag
+        {
+            ANY,
+            FRAUD_ONLY,
+            NOT_FRAUD_ONLY
+        };
+
+        string transactionType; // Empty matches any type
+        string paymentChannel;  // Empty matches any channel
+        FraudFlag fraudFlag = FraudFlag::ANY;
+        double minAmount = -numeric_limits<double>::infinity();
+        double maxAmount = numeric_limits<double>::infinity();
+
+        bool hasAmountRange() const;
+        bool isEmpty() const;
+    };
+
 private:
     int numTransactions = 0;
     Transaction *transactions = nullptr;
@@ -27,28 +82,132 @@ private:
     ifstream fileStream; // For streaming
     bool isStreamMode = false;
     long long totalProcessed = 0;
+    ParseStats parseStats;
+    TransactionFilter filter;
+    bool hasFilter = false;
+    unsigned projection = ALL_COLUMNS;
+    int splitLimit = 16; // Fields to split: enough for the projection and the filter
+
+    // Memory-mapped streaming: lines are walked in place instead of copied out of an ifstream
+    bool useMemoryMap = true;
+    MappedFile mappedFile;
+    const char *mapCursor = nullptr;
+    const char *mapEnd = nullptr;
+    string lineBuffer; // Backing storage for lines read through the ifstream fallback
+
+    // Columnar snapshot: when one built from the current CSV exists, streaming and parallel
+    // loads read it instead of parsing text
+    bool useSnapshot = true;
+    ColumnarSnapshot snapshot;
+    long long snapshotRow = 0;
+
+    // Page index: byte offset of every PAGE_SIZE-th data row, persisted next to the CSV
+    long long *pageOffsets = nullptr;
+    int pageCount = 0;
+    int pageOffsetsCapacity = 0;
+    bool pageIndexComplete = false;
+    long long indexScanOffset = 0; // Where an incomplete index resumes scanning
+    long long indexRowsScanned = -1; // -1 until the header line has been passed
+    ifstream pageStream; // Kept open between page loads
 
     // Helper methods for cleaner code and robust error handling
     bool expandCapacity(int &capacity);
-    ParseResult parseLineWithValidation(const string &line, string &transaction_id,
-                                        string &sender_account, string &receiver_account,
-                                        double &amount, string &transaction_type,
-                                        string &location, string &payment_channel, bool &is_fraud);
+    bool ensurePageIndex(int targetPage);
+    void appendPageOffset(long long offset);
+    void resetPageIndex();
+    string getPageIndexPath() const;
+    bool readPageIndexFile(long long fileSize, long long modifiedTime);
+    void writePageIndexFile(long long fileSize, long long modifiedTime) const;
+    bool readNextLine(string_view &line);
+    // Text fields come back as views into line, valid for as long as the line is
+    ParseResult parseLineWithValidation(string_view line, string_view &transaction_id,
+                                        string_view &sender_account, string_view &receiver_account,
+                                        Amount &amount, string_view &transaction_type,
+                                        string_view &location, string_view &payment_channel, bool &is_fraud) const;
+    ParseResult parseFieldsWithValidation(const string_view fields[], int tokenCount, unsigned columns,
+                                          string_view &transaction_id,
+                                          string_view &sender_account, string_view &receiver_account,
+                                          Amount &amount, string_view &transaction_type,
+                                          string_view &location, string_view &payment_channel, bool &is_fraud) const;
+    bool matchesFilter(const string_view fields[], int tokenCount) const;
+    void updateSplitLimit();
+    bool getSourceVersion(long long &fileSize, long long &modifiedTime) const;
+    bool openFreshSnapshot();
+    bool matchesSnapshotFilter(long long row) const;
+    bool readSnapshotRow(long long row, Transaction &transaction) const; // false if an id cannot be interned
+
+    // Body of the loadFilteredTransactions overloads; Output needs appendBatch(Transaction[], int)
+    template <typename Output>
+    bool loadFilteredInto(const TransactionFilter &rowFilter, Output &output);
+
+    // Parallel parsing: each worker fills its own chunk for one newline-aligned byte range
+    struct ParsedChunk;
+    void parseRange(const char *begin, const char *end, ParsedChunk &chunk) const;
     bool parseLine(const string &line, string &transaction_id, string &sender_account,
                    string &receiver_account, double &amount, string &transaction_type,
                    string &location, string &payment_channel, bool &is_fraud);
 
 public:
+    // Only columns 0..16 are ever inspected, so splitting stops there
+    static const int MAX_FIELDS = 17;
+
     CSVParser();
     ~CSVParser();
     void setFilePath(const std::string &path);
     bool loadNextPage();
+    bool loadPage(int pageNumber); // Random access: seeks straight to the page via the index
+    int getPageCount();            // Forces a full index build when it is not cached yet
     int getNumTransactions();
     Transaction *getTransactions();
 
     // New streaming methods for low memory usage
     bool initializeStreaming();
-    bool getNextTransaction(Transaction &transaction);
+    bool getNextTransaction(Transaction &transaction); // A one-row getNextBatch
+    // Fills up to batchSize caller-owned rows per call (0 at end of stream); the same block
+    // can be passed again and again since rows are overwritten in place
+    int getNextBatch(Transaction batch[], int batchSize);
     void closeStream();
     long long getTotalProcessed() const;
+    const ParseStats &getParseStats() const;
+
+    // Rows rejected by the filter are skipped by getNextTransaction, the loaders and the
+    // parallel parser without being validated or turned into a Transaction
+    void setFilter(const TransactionFilter &rowFilter);
+    void clearFilter();
+
+    // Restricts streaming and parallel parsing to a set of ColumnMask bits. Other fields are
+    // skipped without trimming, copying or validation and stay default in the Transaction;
+    // rows only need to reach the last requested column. Pages always parse every column.
+    void setProjection(unsigned columns);
+    unsigned getProjection() const;
+
+    // Single streaming pass that appends every row passing the filter to output
+    bool loadFilteredTransactions(const TransactionFilter &rowFilter, TransactionBuffer &output);
+    bool loadMatchingTransactions(const string &transactionType, TransactionBuffer &output);
+    // Same pass, appending straight into the column store
+    bool loadFilteredTransactions(const TransactionFilter &rowFilter, TransactionTable &output);
+    bool loadMatchingTransactions(const string &transactionType, TransactionTable &output);
+    // Same pass, keeping only the first k rows per payment channel; output.finish() is called
+    bool loadFilteredTransactions(const TransactionFilter &rowFilter, TopKByChannel &output);
+    bool loadMatchingTransactions(const string &transactionType, TopKByChannel &output);
+
+    // Converts the CSV into a binary columnar snapshot (<csv>.colcache). It is used
+    // automatically while it matches the CSV's size and mtime and every column is projected.
+    bool buildSnapshot();
+    bool hasFreshSnapshot() const;
+    void setSnapshotUse(bool enabled);
+
+    // Parses the whole file on threadCount workers (0 = all cores) and returns the valid
+    // transactions in file order; the caller owns the returned array (delete[])
+    Transaction *parseAllParallel(long long &count, int threadCount = 0);
+
+    // Memory mapping is used by default; disabling it falls back to ifstream + getline
+    void setMemoryMapping(bool enabled);
+    bool isMemoryMapped() const;
+
+    // Splits a raw CSV line into field slices pointing into the line itself (no copies)
+    static int splitFields(string_view line, string_view fields[], int maxFields);
+
+    // Allocation- and exception-free field converter
+    static bool parseBoolField(string_view token);
 };
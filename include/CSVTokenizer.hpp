@@ -0,0 +1,29 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+
+using namespace std;
+
+// Vectorized field splitter for CSV rows. Each 64-byte block of a row is turned into a
+// bitmap of ',' positions (AVX2 or SSE2 when the CPU has them, scalar otherwise), and
+// field boundaries are then read off the bitmap one set bit at a time.
+class CSVTokenizer
+{
+public:
+    enum class InstructionSet
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    // Same splitting rules as getline(ss, token, ','): a trailing comma yields no extra field
+    static int splitFields(string_view line, string_view fields[], int maxFields);
+
+    // Bit i is set when block[i] == ','; block must have 64 readable bytes
+    static uint64_t delimiterMask(const char *block);
+
+    static InstructionSet getInstructionSet();
+    static bool setInstructionSet(InstructionSet instructionSet); // false if the CPU lacks it
+    static bool isSupported(InstructionSet instructionSet);
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "Transaction.hpp"
+#include "MappedFile.hpp"
+
+using namespace std;
+
+// Binary column-store copy of the valid rows of a CSV file. Identifier columns are kept as
+// string heaps, type/location/channel as dictionary codes (remapped onto the shared
+// StringDictionary codes when opened), amounts as int64 millionths and
+// the fraud flag as a packed bitset. Opening one is an mmap plus pointer fixups; rows are
+// read straight out of the mapping.
+class ColumnarSnapshot
+{
+public:
+    enum IdColumn
+    {
+        TRANSACTION_ID_COLUMN,
+        SENDER_ACCOUNT_COLUMN,
+        RECEIVER_ACCOUNT_COLUMN,
+        ID_COLUMN_COUNT
+    };
+
+    enum CategoryColumn
+    {
+        TRANSACTION_TYPE_COLUMN,
+        LOCATION_COLUMN,
+        PAYMENT_CHANNEL_COLUMN,
+        CATEGORY_COLUMN_COUNT
+    };
+
+    // Rejected-row counts of the parse the snapshot was built from
+    struct SourceStats
+    {
+        long long parseErrors = 0;
+        long long validationErrors = 0;
+        long long malformed = 0;
+    };
+
+    // Accumulates rows in compact column buffers and writes the snapshot file
+    class Writer
+    {
+    private:
+        struct State;
+        State *state;
+
+    public:
+        Writer();
+        ~Writer();
+        Writer(const Writer &) = delete;
+        Writer &operator=(const Writer &) = delete;
+
+        bool addRow(const Transaction &transaction); // false when a dictionary is full
+        long long getRowCount() const;
+        bool write(const string &path, long long sourceSize, long long sourceModifiedTime,
+                   const SourceStats &stats) const;
+    };
+
+private:
+    MappedFile file;
+    long long rowCount = 0;
+    SourceStats sourceStats;
+
+    // Column pointers into the mapping, fixed up by open()
+    const uint64_t *idOffsets[ID_COLUMN_COUNT] = {};
+    const char *idBytes[ID_COLUMN_COUNT] = {};
+    const uint16_t *categoryCodes[CATEGORY_COLUMN_COUNT] = {};
+    string_view *dictionaries[CATEGORY_COLUMN_COUNT] = {};
+    uint32_t dictionarySizes[CATEGORY_COLUMN_COUNT] = {};
+    uint16_t *globalCodes[CATEGORY_COLUMN_COUNT] = {}; // Snapshot code -> shared StringDictionary code
+    const int64_t *amountMicros = nullptr;
+    const uint64_t *fraudBits = nullptr;
+
+public:
+    ColumnarSnapshot() = default;
+    ~ColumnarSnapshot();
+    ColumnarSnapshot(const ColumnarSnapshot &) = delete;
+    ColumnarSnapshot &operator=(const ColumnarSnapshot &) = delete;
+
+    // Fails when the file is missing, corrupt, or was built from a different CSV version
+    bool open(const string &path, long long sourceSize, long long sourceModifiedTime);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    long long getRowCount() const { return rowCount; }
+    const SourceStats &getSourceStats() const { return sourceStats; }
+
+    string_view getId(IdColumn column, long long row) const
+    {
+        return string_view(idBytes[column] + idOffsets[column][row],
+                           idOffsets[column][row + 1] - idOffsets[column][row]);
+    }
+    string_view getCategory(CategoryColumn column, long long row) const
+    {
+        return dictionaries[column][categoryCodes[column][row]];
+    }
+    // Code of the value in the matching shared dictionary (see Transaction)
+    uint16_t getCategoryCode(CategoryColumn column, long long row) const
+    {
+        return globalCodes[column][categoryCodes[column][row]];
+    }
+    int64_t getAmountMicros(long long row) const { return amountMicros[row]; }
+    bool getIsFraud(long long row) const { return (fraudBits[row / 64] >> (row % 64)) & 1; }
+
+    static string pathFor(const string &csvPath);
+};
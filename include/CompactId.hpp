@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+using namespace std;
+
+// Identifier packed into 64 bits. The common "letters + digits" form (ACC584714, T100004)
+// is stored inline; anything else is interned in StringDictionary::identifiers() and the
+// word holds its code. Equal identifiers always have equal bits, so comparing is one compare.
+//
+// Packed layout, high to low:
+//   1 bit  tag (1 = packed, 0 = dictionary code)
+//   2 bits prefix length (0-3 letters)
+//   21 bits prefix, 7 bits per ASCII letter
+//   4 bits digit count (1-15, keeps leading zeros)
+//   36 bits numeric value
+class CompactId
+{
+private:
+    uint64_t bits = 0; // Dictionary code 0: the empty string
+
+    static bool pack(string_view text, uint64_t &packed);
+
+public:
+    CompactId() = default;
+
+    // Returns false (leaving the id unchanged) if text is irregular and the dictionary is full
+    bool assign(string_view text);
+
+    bool isPacked() const { return (bits >> 63) != 0; }
+    uint64_t getBits() const { return bits; }
+
+    // Writes the original text; appendTo reuses the caller's buffer
+    void appendTo(string &out) const;
+    string toString() const;
+
+    bool operator==(const CompactId &other) const { return bits == other.bits; }
+    bool operator!=(const CompactId &other) const { return bits != other.bits; }
+};
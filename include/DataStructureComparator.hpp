@@ -6,6 +6,7 @@ using namespace std;
 #include "Transaction.hpp"
 #include "ArrayBasedCollection.hpp"
 #include "LinkedListBasedCollection.hpp"
+#include "TransactionTable.hpp"
 
 class DataStructureComparator
 {
@@ -28,6 +29,19 @@ private:
 
     PerformanceMetrics arrayMetrics;
     PerformanceMetrics linkedListMetrics;
+    PerformanceMetrics tableMetrics;
+    bool tableProcessed = false; // The column-store backend is optional
+
+    // Additional array runs, one per sort mode or engine compared against the default
+    static const int MAX_ARRAY_VARIANTS = 8;
+    struct ArrayVariant
+    {
+        string name;
+        PerformanceMetrics metrics;
+    };
+    ArrayVariant arrayVariants[MAX_ARRAY_VARIANTS];
+    int arrayVariantCount = 0;
+    Amount tableTotalAmount;     // Exact sum of the matched amounts
 
 public:
     DataStructureComparator(Transaction *transactions, int numTransactions, const string &searchKey);
@@ -36,9 +50,17 @@ public:
     // Main comparison function
 
     void processLinkedListStructureSilent();
+    // Builds and processes a linked list per block of batchSize rows and accumulates the timings
+    void processLinkedListInBatches(int batchSize);
 
     void displayFinalSummary();
     void processArrayStructureSilent();
+    // Copies the rows into a TransactionTable and runs the array algorithms on the columns
+    void processTableStructureSilent();
+    // Runs the array algorithms with another sort mode and engine on a private copy of the
+    // rows and reports them under name next to the default array run
+    void processArraySortModeSilent(ArrayBasedCollection::SortMode mode, ArrayBasedCollection::SortEngine engine,
+                                    const string &name);
 
     void setLinkedListTime(long long timeInMicroseconds)
     {
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include "Transaction.hpp"
+
+using namespace std;
+
+// The part of a row the sorts actually read: the (channel, amount, location) key plus the
+// row's position in the Transaction array it was taken from. Sixteen bytes, so merges move a
+// quarter of the data they did with whole rows and four keys share a cache line. The
+// Transaction array is the cold side (ids, accounts, type, fraud flag) and is only touched
+// again through row, for the rows that are printed or gathered.
+struct HotRecord
+{
+    int64_t amountMicros;
+    uint16_t paymentChannelRank; // Dictionary ranks, so comparisons are alphabetical
+    uint16_t locationRank;
+    uint32_t row;
+
+    static HotRecord fromTransaction(const Transaction &transaction, uint32_t row);
+
+    // hot[i] = key of arr[i]
+    static void extract(const Transaction arr[], int count, HotRecord hot[]);
+
+    // Reorders arr so arr[i] becomes the row hot[i] points at, in place by following the
+    // permutation's cycles, so no second copy of the rows is made; hot must be a permutation
+    // of 0..count-1. Afterwards hot[i].row == i, so hot is the key column of the reordered arr.
+    static void gather(Transaction arr[], HotRecord hot[], int count);
+};
+
+static_assert(sizeof(HotRecord) == 16, "HotRecord should stay at 16 bytes");
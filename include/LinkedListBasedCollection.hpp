@@ -3,22 +3,25 @@
 #include <chrono>
 using namespace std;
 #include "Transaction.hpp"
+#include "HotRecord.hpp"
 
 //declaration of LinkedListBasedCollection class
 class LinkedListBasedCollection { 
 private:
+    // Nodes carry only the sort key; the rest of each row stays in the source array
     struct TransactionNode {
-        Transaction transaction;
+        HotRecord record;
         TransactionNode* next;
     };
     
     TransactionNode* head;
+    Transaction* transactions; // Cold rows, indexed by HotRecord::row
     string searchKey;
     int numTransactions;
     
     // Helper methods for linked list operations
     void convertArrayToLinkedList(Transaction *transactions, int numTransactions);
-    void insertTransaction(const Transaction &transaction);
+    void insertTransaction(const Transaction &transaction, uint32_t row);
     void clearLinkedList();
     void clearGroupList(TransactionNode* groupHead);
     
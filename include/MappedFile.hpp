@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+// Read-only memory mapping of a whole file (mmap on POSIX, file mapping on Windows)
+class MappedFile
+{
+private:
+    const char *mappedData = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Mappings own OS handles, so they cannot be copied
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const string &path);
+    void close();
+
+    bool isOpen() const { return mappedData != nullptr; }
+    const char *data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include "Arena.hpp"
+
+using namespace std;
+
+// Interns strings into dense integer codes. Lookups are lock-free, so parser threads can
+// intern concurrently; only adding a new string takes the lock. The text itself is copied
+// into an arena owned by the dictionary, so decoded views never move or dangle.
+//
+// Ordered dictionaries also keep a rank per code: rank(a) < rank(b) exactly when
+// decode(a) < decode(b), so sorting by rank is alphabetical sorting on integers. Ranks are
+// updated as strings are added, so compare them once loading is done.
+class StringDictionary
+{
+public:
+    static const uint32_t INVALID_CODE = 0xFFFFFFFF;
+    static const uint32_t EMPTY_CODE = 0; // The empty string is always code 0
+
+    StringDictionary(uint32_t maxEntries, bool ordered);
+    ~StringDictionary();
+
+    StringDictionary(const StringDictionary &) = delete;
+    StringDictionary &operator=(const StringDictionary &) = delete;
+
+    // Returns the code for value, adding it if needed; INVALID_CODE once the dictionary is full
+    uint32_t intern(string_view value);
+    // Returns the code for value without adding it; INVALID_CODE if it is unknown
+    uint32_t find(string_view value) const;
+
+    string_view decode(uint32_t code) const { return blocks[code / BLOCK_SIZE][code % BLOCK_SIZE]; }
+    uint32_t rank(uint32_t code) const { return ranks[code]; }
+    uint32_t size() const { return entryCount.load(memory_order_acquire); }
+
+    // Shared dictionaries behind the categorical Transaction columns
+    static StringDictionary &transactionTypes();
+    static StringDictionary &locations();
+    static StringDictionary &paymentChannels();
+    // Identifiers that CompactId cannot pack inline
+    static StringDictionary &identifiers();
+
+private:
+    static const uint32_t BLOCK_SIZE = 1024;
+
+    // Open-addressing table of code + 1 (0 = empty). Tables are replaced, never resized in
+    // place, so a reader holding an old table can finish its probe safely.
+    struct SlotTable
+    {
+        uint32_t mask;
+        atomic<uint32_t> *slots;
+        SlotTable *previous; // Retired tables are freed with the dictionary
+    };
+
+    uint32_t maxEntries;
+    bool ordered;
+    string_view **blocks;            // Entries live in fixed blocks so lookups never see a move
+    Arena arena;                     // Text of every entry, appended under writeLock
+    atomic<uint32_t> entryCount;
+    atomic<SlotTable *> table;
+    uint32_t *sortedCodes = nullptr; // Ordered dictionaries: codes in alphabetical order
+    uint32_t *ranks = nullptr;       // Ordered dictionaries: position of each code in sortedCodes
+    mutex writeLock;
+
+    static uint64_t hash(string_view value);
+    static void insertSlot(SlotTable *slotTable, uint64_t valueHash, uint32_t code);
+    SlotTable *grow(SlotTable *current);
+    void insertRank(uint32_t code);
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include "Transaction.hpp"
+
+using namespace std;
+
+// Keeps only the first k rows of every payment channel in the processing order (amount
+// descending, then location, then arrival order), in one bounded heap per channel. Each row
+// costs O(log k) and memory stays at k rows per channel, so it can sit directly behind the
+// streaming parser and the full match set never has to exist. Rows are copied in; call
+// finish() after the last append, then read the channels in alphabetical order.
+class TopKByChannel
+{
+private:
+    struct Entry
+    {
+        Transaction row;
+        long long sequence; // Arrival order, the final tie-break
+    };
+
+    struct Channel
+    {
+        uint16_t code;
+        Entry *heap; // Max-heap on the processing order: the root is the row that sorts last
+        int size;
+    };
+
+    int k;
+    Channel *channels = nullptr;
+    int channelCount = 0;
+    int channelCapacity = 0;
+    int lastChannel = -1; // Consecutive rows often share a channel
+    long long offered = 0;
+
+    Channel &channelFor(uint16_t code);
+    static bool sortsBefore(const Entry &a, const Entry &b);
+    static void siftDown(Entry heap[], int size, int index);
+
+public:
+    explicit TopKByChannel(int k);
+    ~TopKByChannel();
+
+    TopKByChannel(const TopKByChannel &) = delete;
+    TopKByChannel &operator=(const TopKByChannel &) = delete;
+
+    void append(const Transaction &transaction);
+    void appendBatch(const Transaction batch[], int batchSize);
+    void clear();
+
+    // Sorts every channel's rows into processing order and the channels by name
+    void finish();
+
+    int getK() const { return k; }
+    long long getOffered() const { return offered; } // Rows seen, kept or not
+    int getChannelCount() const { return channelCount; }
+    uint16_t getChannelCode(int channel) const { return channels[channel].code; }
+    int getChannelSize(int channel) const { return channels[channel].size; }
+    const Transaction &getRow(int channel, int position) const { return channels[channel].heap[position].row; }
+};
@@ -2,43 +2,95 @@
 #define TRANSACTION_HPP
 
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <iostream>
 #include "json.hpp"
+#include "StringDictionary.hpp"
+#include "CompactId.hpp"
+#include "Amount.hpp"
 using namespace std;
 
 class Transaction
 {
 private:
-    string transactionID;
-    string senderAccount;
-    string receiverAccount;
-    double amount;
-    string transactionType;
-    string location;
-    string paymentChannel;
+    CompactId transactionID;
+    CompactId senderAccount;
+    CompactId receiverAccount;
+    Amount amount;
+    // Categorical columns are codes into the shared StringDictionary instances
+    uint16_t transactionTypeCode = StringDictionary::EMPTY_CODE;
+    uint16_t locationCode = StringDictionary::EMPTY_CODE;
+    uint16_t paymentChannelCode = StringDictionary::EMPTY_CODE;
     bool isFraud;
     int transactionNumber;
 
 public:
-    // Constructor declaration
-    Transaction(const string &transactionID,
-                const string &senderAccount,
-                const string &receiverAccount,
+    // Fields are read through views and packed, so callers never build temporary strings
+    Transaction(string_view transactionID,
+                string_view senderAccount,
+                string_view receiverAccount,
                 double amount,
-                const string &transactionType,
-                const string &location,
-                const string &paymentChannel,
+                string_view transactionType,
+                string_view location,
+                string_view paymentChannel,
                 bool isFraud);
     Transaction() = default; // Default constructor
 
+    // Overwrites every field in place.
+    // Returns false if a value could not be interned (dictionary full).
+    bool assign(string_view transactionID,
+                string_view senderAccount,
+                string_view receiverAccount,
+                Amount amount,
+                string_view transactionType,
+                string_view location,
+                string_view paymentChannel,
+                bool isFraud);
+    // Same as assign, with the categorical columns already encoded
+    bool assignEncoded(string_view transactionID,
+                       string_view senderAccount,
+                       string_view receiverAccount,
+                       Amount amount,
+                       uint16_t transactionTypeCode,
+                       uint16_t locationCode,
+                       uint16_t paymentChannelCode,
+                       bool isFraud);
+    // Same again, with the identifiers already packed (cannot fail)
+    void assignEncoded(CompactId transactionID,
+                       CompactId senderAccount,
+                       CompactId receiverAccount,
+                       Amount amount,
+                       uint16_t transactionTypeCode,
+                       uint16_t locationCode,
+                       uint16_t paymentChannelCode,
+                       bool isFraud);
+
+    // Ids are decoded from their packed form; use the Key getters to compare without copying
     string getTransactionID() const;
     string getSenderAccount() const;
     string getReceiverAccount() const;
-    double getAmount() const;
-    string getTransactionType() const;
-    string getLocation() const;
-    string getPaymentChannel() const;
+    double getAmount() const; // For display; sort and sum with getAmountMicros
+    // Views into the shared dictionaries, valid for the life of the program
+    string_view getTransactionType() const;
+    string_view getLocation() const;
+    string_view getPaymentChannel() const;
     bool getIsFraud() const;
+
+    // Packed identifiers, for equality checks without decoding
+    CompactId getTransactionIDKey() const { return transactionID; }
+    CompactId getSenderAccountKey() const { return senderAccount; }
+    CompactId getReceiverAccountKey() const { return receiverAccount; }
+
+    int64_t getAmountMicros() const { return amount.getMicros(); }
+
+    // Dictionary codes, for equality checks without decoding
+    uint16_t getTransactionTypeCode() const { return transactionTypeCode; }
+    uint16_t getLocationCode() const { return locationCode; }
+    uint16_t getPaymentChannelCode() const { return paymentChannelCode; }
+    // Alphabetical ranks, for ordering without decoding
+    uint32_t getLocationRank() const { return StringDictionary::locations().rank(locationCode); }
+    uint32_t getPaymentChannelRank() const { return StringDictionary::paymentChannels().rank(paymentChannelCode); }
     // show all avalibe Transaction types
      static string formatTransactionTypeForDisplay(const string& internalType);
     static void showUniqueTransactionTypes(Transaction arr[], int numTransactions);
@@ -47,4 +99,9 @@ public:
 
 };
 
+// Rows own no heap memory, so arrays of them are released without running any destructors
+static_assert(is_trivially_destructible<Transaction>::value, "Transaction must stay trivially destructible");
+// ...and copying or moving a row is a plain memberwise copy that never allocates
+static_assert(is_trivially_copyable<Transaction>::value, "Transaction must stay trivially copyable");
+
 #endif
@@ -0,0 +1,38 @@
+#pragma once
+#include "Transaction.hpp"
+
+using namespace std;
+
+// Growable result buffer made of fixed-size chunks. Growing only adds a chunk, so rows
+// already stored are never copied or moved again until moveToArray hands them out.
+class TransactionBuffer
+{
+private:
+    static const int CHUNK_SIZE = 4096;
+
+    Transaction **chunks = nullptr;
+    int chunkCount = 0;
+    int chunkCapacity = 0;
+    long long count = 0;
+
+    void addChunk();
+
+public:
+    TransactionBuffer() = default;
+    ~TransactionBuffer();
+
+    TransactionBuffer(const TransactionBuffer &) = delete;
+    TransactionBuffer &operator=(const TransactionBuffer &) = delete;
+
+    void append(Transaction &&transaction);
+    void append(const Transaction &transaction);
+    void appendBatch(Transaction batch[], int batchSize); // Moves the rows out of batch
+    void clear();
+
+    long long size() const { return count; }
+    Transaction &at(long long index) { return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+    const Transaction &at(long long index) const { return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+    // Moves every row into one contiguous array owned by the caller (delete[]) and empties the buffer
+    Transaction *moveToArray();
+};
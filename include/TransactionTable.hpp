@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include "Transaction.hpp"
+
+using namespace std;
+
+// Column store for transactions: each field lives in its own contiguous array, so a scan
+// over one or two fields only pulls those columns through the cache. RowView gives the
+// familiar Transaction getters on top of the columns.
+class TransactionTable
+{
+private:
+    long long count = 0;
+    long long capacity = 0;
+
+    CompactId *transactionIds = nullptr;
+    CompactId *senderAccounts = nullptr;
+    CompactId *receiverAccounts = nullptr;
+    int64_t *amountMicros = nullptr;
+    uint16_t *typeCodes = nullptr;
+    uint16_t *locationCodes = nullptr;
+    uint16_t *channelCodes = nullptr;
+    uint64_t *fraudBits = nullptr; // One bit per row
+
+    void grow(long long minimumCapacity);
+
+public:
+    // Read-only view of one row with the same accessors as Transaction
+    class RowView
+    {
+    private:
+        const TransactionTable *table;
+        long long row;
+
+    public:
+        RowView(const TransactionTable *table, long long row) : table(table), row(row) {}
+
+        string getTransactionID() const { return table->transactionIds[row].toString(); }
+        string getSenderAccount() const { return table->senderAccounts[row].toString(); }
+        string getReceiverAccount() const { return table->receiverAccounts[row].toString(); }
+        double getAmount() const { return Amount::fromMicros(getAmountMicros()).toDouble(); }
+        int64_t getAmountMicros() const { return table->amountMicros[row]; }
+        string_view getTransactionType() const { return StringDictionary::transactionTypes().decode(getTransactionTypeCode()); }
+        string_view getLocation() const { return StringDictionary::locations().decode(getLocationCode()); }
+        string_view getPaymentChannel() const { return StringDictionary::paymentChannels().decode(getPaymentChannelCode()); }
+        bool getIsFraud() const { return table->getIsFraud(row); }
+
+        uint16_t getTransactionTypeCode() const { return table->typeCodes[row]; }
+        uint16_t getLocationCode() const { return table->locationCodes[row]; }
+        uint16_t getPaymentChannelCode() const { return table->channelCodes[row]; }
+
+        Transaction toTransaction() const;
+        nlohmann::json to_json() const { return toTransaction().to_json(); }
+    };
+
+    TransactionTable() = default;
+    ~TransactionTable();
+
+    TransactionTable(const TransactionTable &) = delete;
+    TransactionTable &operator=(const TransactionTable &) = delete;
+
+    void append(const Transaction &transaction);
+    void appendBatch(const Transaction batch[], int batchSize);
+    void clear();
+
+    long long size() const { return count; }
+    RowView row(long long index) const { return RowView(this, index); }
+
+    // Raw columns for scans and sorts
+    const int64_t *getAmountMicros() const { return amountMicros; }
+    const uint16_t *getTransactionTypeCodes() const { return typeCodes; }
+    const uint16_t *getLocationCodes() const { return locationCodes; }
+    const uint16_t *getPaymentChannelCodes() const { return channelCodes; }
+    bool getIsFraud(long long index) const { return (fraudBits[index / 64] >> (index % 64)) & 1; }
+
+    // Exact sum of the amount column
+    Amount getTotalAmount() const { return Amount::fromMicros(Amount::sumMicros(amountMicros, count)); }
+
+    // Bytes held by the columns for the rows stored
+    size_t memoryUsage() const;
+};
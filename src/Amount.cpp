@@ -0,0 +1,168 @@
+#include "../include/Amount.hpp"
+#include <cmath>
+
+static const uint64_t POWERS_OF_TEN[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull};
+
+static const int MAX_MANTISSA_DIGITS = 18; // Keeps the mantissa well inside 64 bits
+
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+Amount Amount::fromMicros(int64_t micros)
+{
+    Amount amount;
+    amount.micros = micros;
+    return amount;
+}
+
+Amount Amount::fromDouble(double value)
+{
+    Amount amount;
+    double scaled = value * MICROS_PER_UNIT;
+    if (scaled >= 9.2e18)
+        amount.micros = INT64_MAX;
+    else if (scaled <= -9.2e18)
+        amount.micros = -INT64_MAX;
+    else if (scaled == scaled) // NaN stays 0
+        amount.micros = llround(scaled);
+    return amount;
+}
+
+bool Amount::parse(string_view text, Amount &value)
+{
+    size_t i = 0;
+    size_t n = text.size();
+    bool negative = false;
+    if (i < n && (text[i] == '+' || text[i] == '-'))
+    {
+        negative = text[i] == '-';
+        i++;
+    }
+
+    // Value = mantissa * 10^decimalExponent
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int decimalExponent = 0;
+    bool anyDigit = false;
+
+    for (; i < n && isDigit(text[i]); i++)
+    {
+        anyDigit = true;
+        if (significantDigits < MAX_MANTISSA_DIGITS)
+        {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+            if (mantissa != 0)
+                significantDigits++;
+        }
+        else
+        {
+            decimalExponent++; // Integer digits past the mantissa only scale it
+        }
+    }
+
+    if (i < n && text[i] == '.')
+    {
+        for (i++; i < n && isDigit(text[i]); i++)
+        {
+            anyDigit = true;
+            if (significantDigits < MAX_MANTISSA_DIGITS)
+            {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(text[i] - '0');
+                if (mantissa != 0)
+                    significantDigits++;
+                decimalExponent--;
+            }
+        }
+    }
+
+    if (!anyDigit)
+        return false;
+
+    // The exponent only counts when digits follow it, as with stod ("1e" reads as 1)
+    if (i < n && (text[i] == 'e' || text[i] == 'E'))
+    {
+        size_t j = i + 1;
+        bool exponentNegative = false;
+        if (j < n && (text[j] == '+' || text[j] == '-'))
+        {
+            exponentNegative = text[j] == '-';
+            j++;
+        }
+        if (j < n && isDigit(text[j]))
+        {
+            int exponent = 0;
+            for (; j < n && isDigit(text[j]); j++)
+            {
+                if (exponent < 10000)
+                    exponent = exponent * 10 + (text[j] - '0');
+            }
+            decimalExponent += exponentNegative ? -exponent : exponent;
+        }
+    }
+
+    // Scale the mantissa to millionths
+    int scale = decimalExponent + 6;
+    int64_t result = 0;
+    if (mantissa == 0)
+    {
+        result = 0;
+    }
+    else if (scale >= 0)
+    {
+        if (scale > 18 || mantissa > static_cast<uint64_t>(INT64_MAX) / POWERS_OF_TEN[scale])
+            result = INT64_MAX; // Saturate; the range check rejects it
+        else
+            result = static_cast<int64_t>(mantissa * POWERS_OF_TEN[scale]);
+    }
+    else if (-scale <= 19)
+    {
+        uint64_t divisor = POWERS_OF_TEN[-scale];
+        uint64_t remainder = mantissa % divisor;
+        result = static_cast<int64_t>(mantissa / divisor);
+        if (remainder >= divisor - remainder)
+            result++; // Half away from zero
+    }
+
+    value.micros = negative ? -result : result;
+    return true;
+}
+
+void Amount::appendTo(string &out) const
+{
+    uint64_t magnitude = micros < 0 ? 0 - static_cast<uint64_t>(micros) : static_cast<uint64_t>(micros);
+    if (micros < 0)
+        out += '-';
+    out += to_string(magnitude / MICROS_PER_UNIT);
+    out += '.';
+
+    uint64_t fraction = magnitude % MICROS_PER_UNIT;
+    int digits = 6;
+    while (digits > 2 && fraction % 10 == 0)
+    {
+        fraction /= 10;
+        digits--;
+    }
+    for (int d = digits - 1; d >= 0; d--)
+        out += static_cast<char>('0' + fraction / POWERS_OF_TEN[d] % 10);
+}
+
+string Amount::toString() const
+{
+    string text;
+    appendTo(text);
+    return text;
+}
+
+int64_t Amount::sumMicros(const int64_t values[], long long count)
+{
+    int64_t total = 0;
+    for (long long i = 0; i < count; i++)
+        total += values[i];
+    return total;
+}
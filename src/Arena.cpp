@@ -0,0 +1,61 @@
+#include "../include/Arena.hpp"
+#include <cstring>
+#include <cstdint>
+
+Arena::~Arena()
+{
+    reset();
+}
+
+void Arena::addSlab(size_t minimumSize)
+{
+    // Oversized requests get a slab of their own instead of wasting a regular one
+    Slab *slab = new Slab;
+    slab->size = minimumSize > slabSize ? minimumSize : slabSize;
+    slab->data = new char[slab->size];
+    slab->previous = current;
+    current = slab;
+    used = 0;
+    bytesReserved += slab->size;
+}
+
+char *Arena::allocate(size_t bytes, size_t alignment)
+{
+    if (current != nullptr)
+    {
+        uintptr_t address = reinterpret_cast<uintptr_t>(current->data) + used;
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (used + padding + bytes <= current->size)
+        {
+            used += padding + bytes;
+            return current->data + used - bytes;
+        }
+    }
+
+    // new[] memory is aligned for any fundamental type, so a fresh slab needs no padding
+    addSlab(bytes);
+    used = bytes;
+    return current->data;
+}
+
+string_view Arena::copy(string_view text)
+{
+    if (text.empty())
+        return string_view();
+    char *destination = allocate(text.size());
+    memcpy(destination, text.data(), text.size());
+    return string_view(destination, text.size());
+}
+
+void Arena::reset()
+{
+    while (current != nullptr)
+    {
+        Slab *previous = current->previous;
+        delete[] current->data;
+        delete current;
+        current = previous;
+    }
+    used = 0;
+    bytesReserved = 0;
+}
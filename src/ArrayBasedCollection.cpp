@@ -1,6 +1,9 @@
 #include <string>
 #include <iostream>
 #include <chrono>
+#include <cstring>
+#include <thread>
+#include <atomic>
 using namespace std;
 #include "../include/ArrayBasedCollection.hpp"
 
@@ -13,7 +16,29 @@ ArrayBasedCollection::ArrayBasedCollection(string &searchKey, int numTransaction
 
 ArrayBasedCollection::~ArrayBasedCollection()
 {
-    // Destructor - no dynamic memory to clean up since we're not owning the transactions array
+    // The transactions array is not owned; only the permutation is
+    delete[] order;
+}
+
+void ArrayBasedCollection::printChannelHeader(uint16_t channelCode)
+{
+    // Print payment channel header with column names
+    cout << "\n========================================" << endl;
+    cout << "Payment Channel: " << StringDictionary::paymentChannels().decode(channelCode) << endl;
+    cout << "========================================" << endl;
+    cout << "TransactionID | SenderAccount | ReceiverAccount | Amount | TransactionType | Location | Fraud Status" << endl;
+    cout << "--------------------------------------------------------------------------------------------------------" << endl;
+}
+
+void ArrayBasedCollection::printRow(const Transaction &transaction)
+{
+    cout << transaction.getTransactionID() << " | "
+         << transaction.getSenderAccount() << " | "
+         << transaction.getReceiverAccount() << " | "
+         << transaction.getAmount() << " | "
+         << transaction.getTransactionType() << " | "
+         << transaction.getLocation() << " | "
+         << (transaction.getIsFraud() ? "Fraud" : "Not Fraud") << endl;
 }
 
 void ArrayBasedCollection::printGroupedByPaymentChannel(Transaction arr[], int numTransactions, string &searchKey)
@@ -21,68 +46,153 @@ void ArrayBasedCollection::printGroupedByPaymentChannel(Transaction arr[], int n
     if (numTransactions == 0)
         return;
 
-    // Track sorting time for payment channel
-    auto sortStart = chrono::high_resolution_clock::now();
-    mergeSortByPaymentChannel(arr, 0, numTransactions - 1);
-    auto sortEnd = chrono::high_resolution_clock::now();
-    auto channelSortTime = chrono::duration_cast<chrono::milliseconds>(sortEnd - sortStart);
-
-    int i = 0;
     int totalResults = 0;
+    chrono::milliseconds channelSortTime = chrono::milliseconds::zero();
     chrono::milliseconds totalSearchTime = chrono::milliseconds::zero();
     chrono::milliseconds totalAmountSortTime = chrono::milliseconds::zero();
-    cout << "\n========================================" << endl;
-    cout << "Grouped Transactions by Payment Channel" << endl;
-    while (i < numTransactions)
-    {
-        string currentChannel = arr[i].getPaymentChannel();
 
-        // Find the end of this payment channel group
-        int j = i;
-        while (j < numTransactions && arr[j].getPaymentChannel() == currentChannel)
+    if (sortMode == SortMode::TOP_K)
+    {
+        // No sort at all: the heaps already hold each channel's displayed rows
+        TopKByChannel top(DISPLAY_LIMIT);
+        auto selectStart = chrono::high_resolution_clock::now();
+        selectTopK(arr, numTransactions, searchKey, top);
+        auto selectEnd = chrono::high_resolution_clock::now();
+        totalAmountSortTime = chrono::duration_cast<chrono::milliseconds>(selectEnd - selectStart);
+
+        cout << "\n========================================" << endl;
+        cout << "Grouped Transactions by Payment Channel" << endl;
+        for (int c = 0; c < top.getChannelCount(); c++)
         {
-            j++;
+            printChannelHeader(top.getChannelCode(c));
+            for (int k = 0; k < top.getChannelSize(c); ++k)
+            {
+                printRow(top.getRow(c, k));
+            }
+            totalResults += top.getChannelSize(c);
         }
-
-        // Search by transaction type using the new method with timing
-        Transaction *group = new Transaction[j - i];
-        auto searchStart = chrono::high_resolution_clock::now();
-        int groupSize = searchbyTransactionType(arr, i, j, searchKey, group);
-        auto searchEndTime = chrono::high_resolution_clock::now();
-        totalSearchTime += chrono::duration_cast<chrono::milliseconds>(searchEndTime - searchStart);
-
-        // Sort this group by amount (highest first), then by location (alphabetically)
-        if (groupSize > 0)
+    }
+    else if (sortMode == SortMode::PERMUTATION)
+    {
+        // One sort by the full key; each channel is then a contiguous span of the result
+        HotRecord *hot = new HotRecord[numTransactions];
+        int matchingCount = buildPermutation(arr, numTransactions, searchKey, hot, totalSearchTime, totalAmountSortTime);
+
+        cout << "\n========================================" << endl;
+        cout << "Grouped Transactions by Payment Channel" << endl;
+        int i = 0;
+        while (i < matchingCount)
         {
-            auto amountSortStart = chrono::high_resolution_clock::now();
-            mergeSortByAmountThenLocation(group, 0, groupSize - 1);
-            auto amountSortEnd = chrono::high_resolution_clock::now();
-            totalAmountSortTime += chrono::duration_cast<chrono::milliseconds>(amountSortEnd - amountSortStart);
+            int j = i;
+            while (j < matchingCount && hot[j].paymentChannelRank == hot[i].paymentChannelRank)
+            {
+                j++;
+            }
 
-            // Print payment channel header with column names
-            cout << "\n========================================" << endl;
-            cout << "Payment Channel: " << currentChannel << endl;
-            cout << "========================================" << endl;
-            cout << "TransactionID | SenderAccount | ReceiverAccount | Amount | TransactionType | Location | Fraud Status" << endl;
-            cout << "--------------------------------------------------------------------------------------------------------" << endl;
+            printChannelHeader(arr[order[i]].getPaymentChannelCode());
+            int displayCount = min(j - i, DISPLAY_LIMIT);
+            for (int k = i; k < i + displayCount; ++k)
+            {
+                printRow(arr[order[k]]);
+            }
+            totalResults += displayCount;
+            i = j;
+        }
+        delete[] hot;
+    }
+    else if (sortMode == SortMode::BUCKETED)
+    {
+        ChannelSpan *spans = new ChannelSpan[StringDictionary::paymentChannels().size()];
+        HotRecord *hot = new HotRecord[numTransactions];
+        HotRecord *scratch = new HotRecord[numTransactions];
+        auto partitionStart = chrono::high_resolution_clock::now();
+        int spanCount = partitionByPaymentChannel(arr, numTransactions, spans, hot, scratch);
+        auto partitionEnd = chrono::high_resolution_clock::now();
+        channelSortTime = chrono::duration_cast<chrono::milliseconds>(partitionEnd - partitionStart);
 
-            // Print top 10 transactions with formatted columns
-            int displayCount = min(groupSize, 10);
+        auto searchStart = chrono::high_resolution_clock::now();
+        searchBuckets(arr, spans, spanCount, searchKey, hot);
+        auto searchEnd = chrono::high_resolution_clock::now();
+        sortBuckets(spans, spanCount, hot, scratch);
+        auto sortEnd = chrono::high_resolution_clock::now();
+        totalSearchTime = chrono::duration_cast<chrono::milliseconds>(searchEnd - searchStart);
+        totalAmountSortTime = chrono::duration_cast<chrono::milliseconds>(sortEnd - searchEnd);
+
+        cout << "\n========================================" << endl;
+        cout << "Grouped Transactions by Payment Channel" << endl;
+        for (int c = 0; c < spanCount; c++)
+        {
+            if (spans[c].matchCount == 0)
+                continue;
+            printChannelHeader(spans[c].channelCode);
+            int displayCount = min(spans[c].matchCount, DISPLAY_LIMIT);
             for (int k = 0; k < displayCount; ++k)
             {
-                cout << group[k].getTransactionID() << " | "
-                     << group[k].getSenderAccount() << " | "
-                     << group[k].getReceiverAccount() << " | "
-                     << group[k].getAmount() << " | "
-                     << group[k].getTransactionType() << " | "
-                     << group[k].getLocation() << " | "
-                     << (group[k].getIsFraud() ? "Fraud" : "Not Fraud") << endl;
+                printRow(arr[hot[spans[c].start + k].row]);
             }
             totalResults += displayCount;
         }
+        delete[] scratch;
+        delete[] hot;
+        delete[] spans;
+    }
+    else
+    {
+        // One key buffer and one scratch buffer for the whole run: each group's matches are
+        // written over its own slice of hot, so grouping, search and group sorts allocate nothing
+        HotRecord *hot = new HotRecord[numTransactions];
+        HotRecord *scratch = new HotRecord[numTransactions];
+
+        // Track sorting time for payment channel
+        auto sortStart = chrono::high_resolution_clock::now();
+        sortByPaymentChannel(arr, numTransactions, hot, scratch);
+        auto sortEnd = chrono::high_resolution_clock::now();
+        channelSortTime = chrono::duration_cast<chrono::milliseconds>(sortEnd - sortStart);
+
+        int i = 0;
+        cout << "\n========================================" << endl;
+        cout << "Grouped Transactions by Payment Channel" << endl;
+        while (i < numTransactions)
+        {
+            uint16_t currentChannel = arr[i].getPaymentChannelCode();
+
+            // Find the end of this payment channel group
+            int j = i;
+            while (j < numTransactions && arr[j].getPaymentChannelCode() == currentChannel)
+            {
+                j++;
+            }
 
-        delete[] group;
-        i = j;
+            // Search by transaction type using the new method with timing
+            HotRecord *group = hot + i;
+            auto searchStart = chrono::high_resolution_clock::now();
+            int groupSize = searchbyTransactionType(arr, i, j, searchKey, group);
+            auto searchEndTime = chrono::high_resolution_clock::now();
+            totalSearchTime += chrono::duration_cast<chrono::milliseconds>(searchEndTime - searchStart);
+
+            // Sort this group by amount (highest first), then by location (alphabetically)
+            if (groupSize > 0)
+            {
+                auto amountSortStart = chrono::high_resolution_clock::now();
+                sortRecordsByAmountThenLocation(group, scratch + i, groupSize);
+                auto amountSortEnd = chrono::high_resolution_clock::now();
+                totalAmountSortTime += chrono::duration_cast<chrono::milliseconds>(amountSortEnd - amountSortStart);
+
+                printChannelHeader(currentChannel);
+
+                // Print top 10 transactions; only these rows are read in full
+                int displayCount = min(groupSize, DISPLAY_LIMIT);
+                for (int k = 0; k < displayCount; ++k)
+                {
+                    printRow(arr[group[k].row]);
+                }
+                totalResults += displayCount;
+            }
+
+            i = j;
+        }
+        delete[] scratch;
+        delete[] hot;
     }
 
     // Store total timing metrics
@@ -113,9 +223,53 @@ void ArrayBasedCollection::processSilently(Transaction arr[], int numTransaction
         return;
     }
 
+    if (sortMode == SortMode::TOP_K) {
+        // Filtering and selection are one pass, timed as the sort
+        TopKByChannel top(DISPLAY_LIMIT);
+        auto selectStart = chrono::high_resolution_clock::now();
+        selectTopK(arr, numTransactions, searchKey, top);
+        auto selectEnd = chrono::high_resolution_clock::now();
+        searchTime = chrono::milliseconds::zero();
+        sortTime = chrono::duration_cast<chrono::milliseconds>(selectEnd - selectStart);
+        return;
+    }
+
+    if (sortMode == SortMode::BUCKETED) {
+        ChannelSpan *spans = new ChannelSpan[StringDictionary::paymentChannels().size()];
+        HotRecord *hot = new HotRecord[numTransactions];
+        HotRecord *scratch = new HotRecord[numTransactions];
+
+        auto partitionStart = chrono::high_resolution_clock::now();
+        int spanCount = partitionByPaymentChannel(arr, numTransactions, spans, hot, scratch);
+        auto searchStart = chrono::high_resolution_clock::now();
+        searchBuckets(arr, spans, spanCount, searchKey, hot);
+        auto sortStart = chrono::high_resolution_clock::now();
+        sortBuckets(spans, spanCount, hot, scratch);
+        auto sortEnd = chrono::high_resolution_clock::now();
+
+        searchTime = chrono::duration_cast<chrono::milliseconds>(sortStart - searchStart);
+        sortTime = chrono::duration_cast<chrono::milliseconds>((searchStart - partitionStart) + (sortEnd - sortStart));
+        delete[] scratch;
+        delete[] hot;
+        delete[] spans;
+        return;
+    }
+
+    if (sortMode == SortMode::PERMUTATION) {
+        // arr is only read; the result is the row order left in order
+        HotRecord *hot = new HotRecord[numTransactions];
+        buildPermutation(arr, numTransactions, searchKey, hot, searchTime, sortTime);
+        delete[] hot;
+        return;
+    }
+
+    // One key buffer and one scratch buffer serve the channel sort and every group after it
+    HotRecord *hot = new HotRecord[numTransactions];
+    HotRecord *scratch = new HotRecord[numTransactions];
+
     // Sort by payment channel first with timing
     auto channelSortStart = chrono::high_resolution_clock::now();
-    mergeSortByPaymentChannel(arr, 0, numTransactions - 1);
+    sortByPaymentChannel(arr, numTransactions, hot, scratch);
     auto channelSortEnd = chrono::high_resolution_clock::now();
     auto channelSortTime = chrono::duration_cast<chrono::milliseconds>(channelSortEnd - channelSortStart);
 
@@ -123,30 +277,31 @@ void ArrayBasedCollection::processSilently(Transaction arr[], int numTransaction
     chrono::milliseconds totalAmountSortTime = chrono::milliseconds::zero();
     
     int currentIndex = 0;
+    // An unknown type can never match any row
+    uint32_t searchCode = StringDictionary::transactionTypes().find(searchKey);
     
     while (currentIndex < numTransactions) {
-        string currentChannel = transactions[currentIndex].getPaymentChannel();
+        uint16_t currentChannel = transactions[currentIndex].getPaymentChannelCode();
         
         // Find the range of transactions for this channel
         int channelStart = currentIndex;
         int channelEnd = currentIndex;
         while (channelEnd < numTransactions && 
-               transactions[channelEnd].getPaymentChannel() == currentChannel) {
+               transactions[channelEnd].getPaymentChannelCode() == currentChannel) {
             channelEnd++;
         }
-        int channelSize = channelEnd - channelStart;
 
         // Search for matching transactions with timing (SILENTLY)
         auto searchStart = chrono::high_resolution_clock::now();
         
-        // Create temporary array for matching transactions
-        Transaction* matchingTransactions = new Transaction[channelSize];
+        // The channel's slice of hot holds the sort keys of its matching transactions
+        HotRecord* matchingTransactions = hot + channelStart;
         int matchingCount = 0;
         
         // Search in the channel range
         for (int i = channelStart; i < channelEnd; i++) {
-            if (transactions[i].getTransactionType() == searchKey) {
-                matchingTransactions[matchingCount] = transactions[i];
+            if (transactions[i].getTransactionTypeCode() == searchCode) {
+                matchingTransactions[matchingCount] = HotRecord::fromTransaction(transactions[i], i);
                 matchingCount++;
             }
         }
@@ -157,139 +312,633 @@ void ArrayBasedCollection::processSilently(Transaction arr[], int numTransaction
         if (matchingCount > 0) {
             // Sort the matching group with timing (SILENTLY)
             auto amountSortStart = chrono::high_resolution_clock::now();
-            mergeSortByAmountThenLocation(matchingTransactions, 0, matchingCount - 1);
+            sortRecordsByAmountThenLocation(matchingTransactions, scratch + channelStart, matchingCount);
             auto amountSortEnd = chrono::high_resolution_clock::now();
             totalAmountSortTime += chrono::duration_cast<chrono::milliseconds>(amountSortEnd - amountSortStart);
 
             // NO PRINTING - just process silently
         }
 
-        // Clean up temporary array
-        delete[] matchingTransactions;
-        
         // Move to next channel
         currentIndex = channelEnd;
     }
+    delete[] scratch;
+    delete[] hot;
+
+    // Store total timing metrics
+    searchTime = totalSearchTime;
+    sortTime = channelSortTime + totalAmountSortTime;
+}
+
+// Process the column store silently: same grouping, search and sorts as processSilently
+void ArrayBasedCollection::processTableSilently(const TransactionTable &table, string &searchKey)
+{
+    int rowCount = static_cast<int>(table.size());
+    if (rowCount == 0) {
+        return;
+    }
+
+    int *indices = new int[rowCount];
+    int *scratch = new int[rowCount];
+    for (int i = 0; i < rowCount; i++) {
+        indices[i] = i;
+    }
+
+    // Sort by payment channel first with timing
+    auto channelSortStart = chrono::high_resolution_clock::now();
+    mergeSortIndicesByPaymentChannel(table, indices, scratch, 0, rowCount - 1);
+    auto channelSortEnd = chrono::high_resolution_clock::now();
+    auto channelSortTime = chrono::duration_cast<chrono::milliseconds>(channelSortEnd - channelSortStart);
+
+    chrono::milliseconds totalSearchTime = chrono::milliseconds::zero();
+    chrono::milliseconds totalAmountSortTime = chrono::milliseconds::zero();
+
+    const uint16_t *channelCodes = table.getPaymentChannelCodes();
+    const uint16_t *typeCodes = table.getTransactionTypeCodes();
+    uint32_t searchCode = StringDictionary::transactionTypes().find(searchKey);
+    int *matchingRows = new int[rowCount];
+
+    int currentIndex = 0;
+    while (currentIndex < rowCount) {
+        uint16_t currentChannel = channelCodes[indices[currentIndex]];
+
+        // Find the range of rows for this channel
+        int channelEnd = currentIndex;
+        while (channelEnd < rowCount && channelCodes[indices[channelEnd]] == currentChannel) {
+            channelEnd++;
+        }
+
+        // Search only touches the type column
+        auto searchStart = chrono::high_resolution_clock::now();
+        int matchingCount = 0;
+        for (int i = currentIndex; i < channelEnd; i++) {
+            if (typeCodes[indices[i]] == searchCode) {
+                matchingRows[matchingCount++] = indices[i];
+            }
+        }
+        auto searchEnd = chrono::high_resolution_clock::now();
+        totalSearchTime += chrono::duration_cast<chrono::milliseconds>(searchEnd - searchStart);
+
+        if (matchingCount > 0) {
+            auto amountSortStart = chrono::high_resolution_clock::now();
+            mergeSortIndicesByAmountThenLocation(table, matchingRows, scratch, 0, matchingCount - 1);
+            auto amountSortEnd = chrono::high_resolution_clock::now();
+            totalAmountSortTime += chrono::duration_cast<chrono::milliseconds>(amountSortEnd - amountSortStart);
+        }
+
+        currentIndex = channelEnd;
+    }
+
+    delete[] matchingRows;
+    delete[] scratch;
+    delete[] indices;
 
     // Store total timing metrics
     searchTime = totalSearchTime;
     sortTime = channelSortTime + totalAmountSortTime;
 }
+
 // Helper function to translate internal type names to user-friendly names
 
-int ArrayBasedCollection::searchbyTransactionType(Transaction arr[], int start, int end, string &searchKey, Transaction *group)
+int ArrayBasedCollection::searchbyTransactionType(Transaction arr[], int start, int end, string &searchKey, HotRecord *group)
 {
 
     int groupSize = 0;
+    uint32_t searchCode = StringDictionary::transactionTypes().find(searchKey);
     for (int j = start; j < end; ++j)
     {
-        if (arr[j].getTransactionType() == searchKey)
+        if (arr[j].getTransactionTypeCode() == searchCode)
         {
-            group[groupSize++] = arr[j];
+            group[groupSize++] = HotRecord::fromTransaction(arr[j], j);
         }
     }
     return groupSize;
 }
 
-void ArrayBasedCollection::mergeByPaymentChannel(Transaction arr[], int left, int mid, int right)
+// Runs at or below this length are finished with insertion sort (tuned on 1M and 10M rows)
+static const int INSERTION_SORT_CUTOFF = 24;
+// Below this many records the radix engine's histogram costs more than a merge sort
+static const int RADIX_MIN_COUNT = 256;
+// The parallel engine stops splitting ranges below this size and sorts them on one thread
+static const int PARALLEL_GRAIN = 1 << 14;
+
+// Amount descending as an ascending 40-bit field. Validated amounts are at most 10^12
+// millionths; anything negative or past 40 bits makes the radix engine fall back to merge sort.
+static const uint64_t AMOUNT_FIELD_MAX = (1ull << 40) - 1;
+static bool packAmountDescending(int64_t micros, uint64_t &field)
 {
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
+    if (micros < 0 || static_cast<uint64_t>(micros) > AMOUNT_FIELD_MAX)
+        return false;
+    field = AMOUNT_FIELD_MAX - static_cast<uint64_t>(micros);
+    return true;
+}
+
+// Each ordering is a comparator for the merge sort plus packKey, which maps a record to a
+// 64-bit key whose unsigned ascending order is the same ordering, for the radix sort.
 
-    Transaction *L = new Transaction[n1];
-    Transaction *R = new Transaction[n2];
+// Channel ascending; ranks order the channel codes alphabetically
+struct ByPaymentChannel
+{
+    bool operator()(const HotRecord &a, const HotRecord &b) const
+    {
+        return a.paymentChannelRank < b.paymentChannelRank;
+    }
 
-    for (int i = 0; i < n1; ++i)
-        L[i] = arr[left + i];
-    for (int j = 0; j < n2; ++j)
-        R[j] = arr[mid + 1 + j];
+    static bool packKey(const HotRecord &record, uint64_t &key)
+    {
+        key = record.paymentChannelRank;
+        return true;
+    }
+};
 
-    int i = 0, j = 0, k = left;
-    while (i < n1 && j < n2)
+// Amount descending, then location ascending
+struct ByAmountThenLocation
+{
+    bool operator()(const HotRecord &a, const HotRecord &b) const
+    {
+        if (a.amountMicros != b.amountMicros)
+            return a.amountMicros > b.amountMicros;
+        return a.locationRank < b.locationRank;
+    }
+
+    // [ inverted amount : 40 | location rank : 16 ]
+    static bool packKey(const HotRecord &record, uint64_t &key)
+    {
+        uint64_t amount;
+        if (!packAmountDescending(record.amountMicros, amount))
+            return false;
+        key = amount << 16 | record.locationRank;
+        return true;
+    }
+};
+
+// The whole processing order: channel, then amount descending, then location
+struct ByChannelAmountLocation
+{
+    bool operator()(const HotRecord &a, const HotRecord &b) const
     {
-        if (L[i].getPaymentChannel() <= R[j].getPaymentChannel())
+        if (a.paymentChannelRank != b.paymentChannelRank)
+            return a.paymentChannelRank < b.paymentChannelRank;
+        return ByAmountThenLocation()(a, b);
+    }
+
+    // [ channel rank : 8 | inverted amount : 40 | location rank : 16 ]; more than 256 channels
+    // falls back to merge sort
+    static bool packKey(const HotRecord &record, uint64_t &key)
+    {
+        uint64_t amountAndLocation;
+        if (record.paymentChannelRank > 0xFF || !ByAmountThenLocation::packKey(record, amountAndLocation))
+            return false;
+        key = static_cast<uint64_t>(record.paymentChannelRank) << 56 | amountAndLocation;
+        return true;
+    }
+};
+
+// Stable: an element only moves past neighbours that sort strictly after it
+template <typename Before>
+static void insertionSort(HotRecord arr[], int left, int right, Before before)
+{
+    for (int i = left + 1; i <= right; ++i)
+    {
+        HotRecord key = arr[i];
+        int j = i - 1;
+        while (j >= left && before(key, arr[j]))
         {
-            arr[k++] = L[i++];
+            arr[j + 1] = arr[j];
+            --j;
         }
+        arr[j + 1] = key;
+    }
+}
+
+// Merges the sorted runs a[0..n1) and b[0..n2) into out. Ties take a first, which keeps the
+// sort stable.
+template <typename Before>
+static void mergeRanges(const HotRecord a[], int n1, const HotRecord b[], int n2, HotRecord out[], Before before)
+{
+    int i = 0, j = 0, k = 0;
+    while (i < n1 && j < n2)
+    {
+        if (before(b[j], a[i]))
+            out[k++] = b[j++];
         else
-        {
-            arr[k++] = R[j++];
-        }
+            out[k++] = a[i++];
     }
     while (i < n1)
-        arr[k++] = L[i++];
+        out[k++] = a[i++];
     while (j < n2)
-        arr[k++] = R[j++];
+        out[k++] = b[j++];
+}
+
+// Merges the sorted runs from[left..mid] and from[mid+1..right] into to[left..right]
+template <typename Before>
+static void mergeRuns(const HotRecord from[], HotRecord to[], int left, int mid, int right, Before before)
+{
+    mergeRanges(from + left, mid - left + 1, from + mid + 1, right - mid, to + left, before);
+}
+
+// Sorts from[left..right] into to[left..right]; both must start with the same contents.
+// Each level swaps the roles of the two buffers, so merges never copy their input first.
+template <typename Before>
+static void mergeSortInto(HotRecord from[], HotRecord to[], int left, int right, Before before)
+{
+    if (right - left < INSERTION_SORT_CUTOFF)
+    {
+        insertionSort(to, left, right, before);
+        return;
+    }
+    int mid = left + (right - left) / 2;
+    mergeSortInto(to, from, left, mid, before);
+    mergeSortInto(to, from, mid + 1, right, before);
+    mergeRuns(from, to, left, mid, right, before);
+}
 
-    delete[] L;
-    delete[] R;
+template <typename Before>
+static void mergeSortRecords(HotRecord arr[], HotRecord scratch[], int count, Before before)
+{
+    if (count <= 1)
+        return;
+    // Records are trivially copyable, so seeding the scratch buffer is one block copy
+    memcpy(scratch, arr, static_cast<size_t>(count) * sizeof(HotRecord));
+    mergeSortInto(scratch, arr, 0, count - 1, before);
 }
 
-void ArrayBasedCollection::mergeSortByPaymentChannel(Transaction arr[], int left, int right)
+// How many of the first k merged outputs come from a, for the same tie rule as mergeRanges:
+// a[i] lands among them exactly when b[k - i - 1] does not sort strictly before it.
+template <typename Before>
+static int mergeSplit(const HotRecord a[], int n1, const HotRecord b[], int n2, int k, Before before)
 {
-    if (left < right)
+    int low = k > n2 ? k - n2 : 0;
+    int high = k < n1 ? k : n1;
+    while (low < high)
     {
-        int mid = left + (right - left) / 2;
-        mergeSortByPaymentChannel(arr, left, mid);
-        mergeSortByPaymentChannel(arr, mid + 1, right);
-        mergeByPaymentChannel(arr, left, mid, right);
+        int i = low + (high - low) / 2;
+        if (!before(b[k - i - 1], a[i]))
+            low = i + 1;
+        else
+            high = i;
     }
+    return low;
 }
 
-void ArrayBasedCollection::mergeByAmountThenLocation(Transaction arr[], int left, int mid, int right)
+// Same result as mergeRuns, with the output cut into threadCount equal slices. Each slice
+// finds where it starts in both runs by binary search and is merged independently.
+template <typename Before>
+static void parallelMergeRuns(const HotRecord from[], HotRecord to[], int left, int mid, int right, Before before, int threadCount)
 {
+    const HotRecord *a = from + left;
+    const HotRecord *b = from + mid + 1;
     int n1 = mid - left + 1;
     int n2 = right - mid;
+    int total = n1 + n2;
 
-    Transaction *L = new Transaction[n1];
-    Transaction *R = new Transaction[n2];
+    int *splits = new int[threadCount + 1];
+    for (int t = 0; t <= threadCount; t++)
+        splits[t] = mergeSplit(a, n1, b, n2, static_cast<int>(static_cast<long long>(total) * t / threadCount), before);
+
+    thread *workers = new thread[threadCount - 1];
+    for (int t = 0; t < threadCount; t++)
+    {
+        int outStart = static_cast<int>(static_cast<long long>(total) * t / threadCount);
+        int outEnd = static_cast<int>(static_cast<long long>(total) * (t + 1) / threadCount);
+        int aStart = splits[t], aEnd = splits[t + 1];
+        int bStart = outStart - aStart, bEnd = outEnd - aEnd;
+        if (t < threadCount - 1)
+            workers[t] = thread(mergeRanges<Before>, a + aStart, aEnd - aStart, b + bStart, bEnd - bStart, to + left + outStart, before);
+        else
+            mergeRanges(a + aStart, aEnd - aStart, b + bStart, bEnd - bStart, to + left + outStart, before);
+    }
+    for (int t = 0; t < threadCount - 1; t++)
+        workers[t].join();
+    delete[] workers;
+    delete[] splits;
+}
 
-    for (int i = 0; i < n1; ++i)
-        L[i] = arr[left + i];
-    for (int j = 0; j < n2; ++j)
-        R[j] = arr[mid + 1 + j];
+// mergeSortInto with the two halves sorted as separate tasks, each given part of the thread
+// budget, down to PARALLEL_GRAIN; levels that still have several threads merge in parallel.
+// Stable merges have exactly one possible result, so the output never depends on threadCount.
+template <typename Before>
+static void parallelMergeSortInto(HotRecord from[], HotRecord to[], int left, int right, Before before, int threadCount)
+{
+    if (threadCount <= 1 || right - left + 1 < PARALLEL_GRAIN)
+    {
+        mergeSortInto(from, to, left, right, before);
+        return;
+    }
+    int mid = left + (right - left) / 2;
+    int leftThreads = threadCount / 2;
+    thread leftTask(parallelMergeSortInto<Before>, to, from, left, mid, before, leftThreads);
+    parallelMergeSortInto(to, from, mid + 1, right, before, threadCount - leftThreads);
+    leftTask.join();
+    parallelMergeRuns(from, to, left, mid, right, before, threadCount);
+}
 
-    int i = 0, j = 0, k = left;
-    while (i < n1 && j < n2)
+template <typename Before>
+static void parallelMergeSortRecords(HotRecord arr[], HotRecord scratch[], int count, Before before, int threadCount)
+{
+    if (count <= 1)
+        return;
+    memcpy(scratch, arr, static_cast<size_t>(count) * sizeof(HotRecord));
+    parallelMergeSortInto(scratch, arr, 0, count - 1, before, threadCount);
+}
+
+struct RadixEntry
+{
+    uint64_t key;
+    uint32_t index; // Position in the record array being sorted
+};
+
+// LSD radix sort on 8-bit digits. Equal keys keep their relative order (every pass is a
+// stable scatter), and digits that are the same in every key are skipped, so a 16-bit
+// channel key costs two passes and the full processing key at most eight.
+static void radixSortEntries(RadixEntry entries[], RadixEntry scratch[], int count)
+{
+    // Digit counts do not change when entries move, so one histogram pass serves every digit
+    int counts[8][256] = {};
+    for (int i = 0; i < count; i++)
+    {
+        uint64_t key = entries[i].key;
+        for (int d = 0; d < 8; d++)
+            counts[d][(key >> (8 * d)) & 0xFF]++;
+    }
+
+    RadixEntry *from = entries;
+    RadixEntry *to = scratch;
+    for (int d = 0; d < 8; d++)
     {
-        // Primary sort: by amount (descending - highest first)
-        if (L[i].getAmount() > R[j].getAmount())
+        int shift = 8 * d;
+        if (counts[d][(from[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        int offsets[256];
+        int next = 0;
+        for (int b = 0; b < 256; b++)
         {
-            arr[k++] = L[i++];
+            offsets[b] = next;
+            next += counts[d][b];
         }
-        else if (L[i].getAmount() < R[j].getAmount())
+        for (int i = 0; i < count; i++)
+            to[offsets[(from[i].key >> shift) & 0xFF]++] = from[i];
+
+        RadixEntry *swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != entries)
+        memcpy(entries, from, static_cast<size_t>(count) * sizeof(RadixEntry));
+}
+
+// Builds every packed key once, radix-sorts (key, index) pairs, then reorders the records in
+// one gather pass. Gives exactly the merge sort's order, ties included; falls back to it for
+// small inputs and for records whose key does not pack.
+template <typename Order>
+static void radixSortRecords(HotRecord arr[], HotRecord scratch[], int count, Order order)
+{
+    if (count < RADIX_MIN_COUNT)
+    {
+        mergeSortRecords(arr, scratch, count, order);
+        return;
+    }
+
+    RadixEntry *entries = new RadixEntry[count];
+    for (int i = 0; i < count; i++)
+    {
+        if (!Order::packKey(arr[i], entries[i].key))
         {
-            arr[k++] = R[j++];
+            delete[] entries;
+            mergeSortRecords(arr, scratch, count, order);
+            return;
         }
-        else
+        entries[i].index = static_cast<uint32_t>(i);
+    }
+
+    RadixEntry *entryScratch = new RadixEntry[count];
+    radixSortEntries(entries, entryScratch, count);
+    delete[] entryScratch;
+
+    for (int k = 0; k < count; k++)
+        scratch[k] = arr[entries[k].index];
+    memcpy(arr, scratch, static_cast<size_t>(count) * sizeof(HotRecord));
+    delete[] entries;
+}
+
+// 0 means every core
+static int resolveThreadCount(int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = static_cast<int>(thread::hardware_concurrency());
+    return threadCount > 0 ? threadCount : 1;
+}
+
+template <typename Order>
+static void sortRecords(ArrayBasedCollection::SortEngine engine, int threadCount, HotRecord arr[], HotRecord scratch[], int count, Order order)
+{
+    if (engine == ArrayBasedCollection::SortEngine::RADIX)
+    {
+        radixSortRecords(arr, scratch, count, order);
+    }
+    else if (engine == ArrayBasedCollection::SortEngine::PARALLEL_MERGE)
+    {
+        parallelMergeSortRecords(arr, scratch, count, order, resolveThreadCount(threadCount));
+    }
+    else
+    {
+        mergeSortRecords(arr, scratch, count, order);
+    }
+}
+
+void ArrayBasedCollection::sortByPaymentChannel(Transaction arr[], int numTransactions, HotRecord hot[], HotRecord scratch[])
+{
+    HotRecord::extract(arr, numTransactions, hot);
+    sortRecordsByPaymentChannel(hot, scratch, numTransactions);
+    HotRecord::gather(arr, hot, numTransactions);
+}
+
+void ArrayBasedCollection::sortRecordsByPaymentChannel(HotRecord arr[], HotRecord scratch[], int count)
+{
+    sortRecords(sortEngine, threadCount, arr, scratch, count, ByPaymentChannel());
+}
+
+void ArrayBasedCollection::sortRecordsByAmountThenLocation(HotRecord arr[], HotRecord scratch[], int count)
+{
+    sortRecords(sortEngine, threadCount, arr, scratch, count, ByAmountThenLocation());
+}
+
+int ArrayBasedCollection::partitionByPaymentChannel(Transaction arr[], int numTransactions, ChannelSpan spans[], HotRecord hot[], HotRecord scratch[])
+{
+    // Histogram over channel ranks, so the buckets come out in alphabetical order
+    uint32_t rankCount = StringDictionary::paymentChannels().size();
+    int *offsets = new int[rankCount + 1]();
+    HotRecord::extract(arr, numTransactions, scratch);
+    for (int i = 0; i < numTransactions; i++)
+        offsets[scratch[i].paymentChannelRank + 1]++;
+    for (uint32_t r = 0; r < rankCount; r++)
+        offsets[r + 1] += offsets[r];
+
+    int spanCount = 0;
+    for (uint32_t r = 0; r < rankCount; r++)
+    {
+        if (offsets[r + 1] > offsets[r])
         {
-            // Secondary sort: by location (ascending - alphabetical)
-            if (L[i].getLocation() <= R[j].getLocation())
-            {
-                arr[k++] = L[i++];
-            }
-            else
-            {
-                arr[k++] = R[j++];
-            }
+            spans[spanCount].start = offsets[r];
+            spans[spanCount].end = offsets[r + 1];
+            spans[spanCount].matchCount = 0;
+            spanCount++;
         }
     }
-    while (i < n1)
-        arr[k++] = L[i++];
-    while (j < n2)
-        arr[k++] = R[j++];
 
-    delete[] L;
-    delete[] R;
+    // Scatter the keys in input order, which keeps each bucket stable, then move the rows once
+    for (int i = 0; i < numTransactions; i++)
+        hot[offsets[scratch[i].paymentChannelRank]++] = scratch[i];
+    HotRecord::gather(arr, hot, numTransactions);
+    for (int c = 0; c < spanCount; c++)
+        spans[c].channelCode = arr[spans[c].start].getPaymentChannelCode();
+
+    delete[] offsets;
+    return spanCount;
+}
+
+void ArrayBasedCollection::searchBuckets(const Transaction arr[], ChannelSpan spans[], int spanCount, const string &searchKey, HotRecord hot[])
+{
+    uint32_t searchCode = StringDictionary::transactionTypes().find(searchKey);
+    for (int c = 0; c < spanCount; c++)
+    {
+        int matchCount = 0;
+        for (int i = spans[c].start; i < spans[c].end; i++)
+        {
+            if (arr[i].getTransactionTypeCode() == searchCode)
+                hot[spans[c].start + matchCount++] = HotRecord::fromTransaction(arr[i], static_cast<uint32_t>(i));
+        }
+        spans[c].matchCount = matchCount;
+    }
+}
+
+void ArrayBasedCollection::sortBuckets(ChannelSpan spans[], int spanCount, HotRecord hot[], HotRecord scratch[])
+{
+    // Buckets own disjoint ranges of hot and scratch, so they sort without any locking. The
+    // parallelism is across buckets, so each bucket itself uses a single-threaded engine.
+    SortEngine bucketEngine = sortEngine == SortEngine::PARALLEL_MERGE ? SortEngine::MERGE : sortEngine;
+    atomic<int> nextSpan(0);
+    auto sortSpans = [&]()
+    {
+        int c;
+        while ((c = nextSpan.fetch_add(1)) < spanCount)
+        {
+            sortRecords(bucketEngine, 1, hot + spans[c].start, scratch + spans[c].start, spans[c].matchCount, ByAmountThenLocation());
+        }
+    };
+
+    int workerCount = min(resolveThreadCount(threadCount), spanCount);
+    thread *workers = new thread[workerCount > 1 ? workerCount - 1 : 1];
+    for (int w = 0; w < workerCount - 1; w++)
+        workers[w] = thread(sortSpans);
+    sortSpans();
+    for (int w = 0; w < workerCount - 1; w++)
+        workers[w].join();
+    delete[] workers;
+}
+
+void ArrayBasedCollection::selectTopK(const Transaction arr[], int numTransactions, const string &searchKey, TopKByChannel &top)
+{
+    uint32_t searchCode = StringDictionary::transactionTypes().find(searchKey);
+    for (int i = 0; i < numTransactions; i++)
+    {
+        if (arr[i].getTransactionTypeCode() == searchCode)
+            top.append(arr[i]);
+    }
+    top.finish();
+}
+
+int ArrayBasedCollection::buildPermutation(const Transaction arr[], int numTransactions, const string &searchKey, HotRecord hot[],
+                                           chrono::milliseconds &searchElapsed, chrono::milliseconds &sortElapsed)
+{
+    delete[] order;
+    order = new uint32_t[numTransactions > 0 ? numTransactions : 1];
+    orderSize = 0;
+
+    auto searchStart = chrono::high_resolution_clock::now();
+    uint32_t searchCode = StringDictionary::transactionTypes().find(searchKey);
+    int matchingCount = 0;
+    for (int i = 0; i < numTransactions; i++)
+    {
+        if (arr[i].getTransactionTypeCode() == searchCode)
+            hot[matchingCount++] = HotRecord::fromTransaction(arr[i], static_cast<uint32_t>(i));
+    }
+    auto searchEnd = chrono::high_resolution_clock::now();
+
+    // Stable, so rows with equal keys keep their input order, as in the grouped in-place sort
+    HotRecord *scratch = new HotRecord[matchingCount > 0 ? matchingCount : 1];
+    sortRecords(sortEngine, threadCount, hot, scratch, matchingCount, ByChannelAmountLocation());
+    delete[] scratch;
+    for (int k = 0; k < matchingCount; k++)
+        order[k] = hot[k].row;
+    orderSize = matchingCount;
+    auto sortEnd = chrono::high_resolution_clock::now();
+
+    searchElapsed = chrono::duration_cast<chrono::milliseconds>(searchEnd - searchStart);
+    sortElapsed = chrono::duration_cast<chrono::milliseconds>(sortEnd - searchEnd);
+    return matchingCount;
 }
 
-void ArrayBasedCollection::mergeSortByAmountThenLocation(Transaction arr[], int left, int right)
+void ArrayBasedCollection::mergeSortIndicesByPaymentChannel(const TransactionTable &table, int indices[], int scratch[], int left, int right)
 {
-    if (left < right)
+    if (left >= right)
+        return;
+
+    int mid = left + (right - left) / 2;
+    mergeSortIndicesByPaymentChannel(table, indices, scratch, left, mid);
+    mergeSortIndicesByPaymentChannel(table, indices, scratch, mid + 1, right);
+
+    const uint16_t *channelCodes = table.getPaymentChannelCodes();
+    const StringDictionary &channels = StringDictionary::paymentChannels();
+    for (int k = left; k <= right; ++k)
+        scratch[k] = indices[k];
+
+    int i = left, j = mid + 1, k = left;
+    while (i <= mid && j <= right)
+    {
+        if (channels.rank(channelCodes[scratch[i]]) <= channels.rank(channelCodes[scratch[j]]))
+            indices[k++] = scratch[i++];
+        else
+            indices[k++] = scratch[j++];
+    }
+    while (i <= mid)
+        indices[k++] = scratch[i++];
+    while (j <= right)
+        indices[k++] = scratch[j++];
+}
+
+void ArrayBasedCollection::mergeSortIndicesByAmountThenLocation(const TransactionTable &table, int indices[], int scratch[], int left, int right)
+{
+    if (left >= right)
+        return;
+
+    int mid = left + (right - left) / 2;
+    mergeSortIndicesByAmountThenLocation(table, indices, scratch, left, mid);
+    mergeSortIndicesByAmountThenLocation(table, indices, scratch, mid + 1, right);
+
+    const int64_t *amountMicros = table.getAmountMicros();
+    const uint16_t *locationCodes = table.getLocationCodes();
+    const StringDictionary &locations = StringDictionary::locations();
+    for (int k = left; k <= right; ++k)
+        scratch[k] = indices[k];
+
+    int i = left, j = mid + 1, k = left;
+    while (i <= mid && j <= right)
     {
-        int mid = left + (right - left) / 2;
-        mergeSortByAmountThenLocation(arr, left, mid);
-        mergeSortByAmountThenLocation(arr, mid + 1, right);
-        mergeByAmountThenLocation(arr, left, mid, right);
+        // Amount descending, then location ascending
+        int64_t leftAmount = amountMicros[scratch[i]];
+        int64_t rightAmount = amountMicros[scratch[j]];
+        bool takeLeft = leftAmount > rightAmount ||
+                        (leftAmount == rightAmount &&
+                         locations.rank(locationCodes[scratch[i]]) <= locations.rank(locationCodes[scratch[j]]));
+        if (takeLeft)
+            indices[k++] = scratch[i++];
+        else
+            indices[k++] = scratch[j++];
     }
-}
\ No newline at end of file
+    while (i <= mid)
+        indices[k++] = scratch[i++];
+    while (j <= right)
+        indices[k++] = scratch[j++];
+}
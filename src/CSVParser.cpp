@@ -1,5 +1,10 @@
 #include "../include/CSVParser.hpp"
+#include "../include/CSVTokenizer.hpp"
 #include <filesystem>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <functional>
 
 const int PAGE_SIZE = 1000; // Much smaller page size for low memory usage
 
@@ -13,16 +18,24 @@ CSVParser::~CSVParser()
         transactions = nullptr;
     }
     closeStream();
+    resetPageIndex();
 }
 
 void CSVParser::setFilePath(const string &path)
 {
     filePath = path;
     pageCounter = 0;
+    resetPageIndex();
 }
 
-// Always loads the next page of data from the CSV file
+// Loads the page after the last one loaded
 bool CSVParser::loadNextPage()
+{
+    return loadPage(pageCounter);
+}
+
+// Loads one page of data by seeking to its indexed byte offset
+bool CSVParser::loadPage(int pageNumber)
 {
     if (filePath.empty())
     {
@@ -37,97 +50,338 @@ bool CSVParser::loadNextPage()
     }
     numTransactions = 0;
 
-    ifstream file(filePath);
-    if (!file.is_open())
+    if (!ensurePageIndex(pageNumber))
     {
-        cerr << "   ERROR: Cannot open file " << filePath << endl;
         return false;
     }
 
-    int startLine = pageCounter * PAGE_SIZE;
-    int endLine = startLine + PAGE_SIZE;
-    int currentLine = 0;
-    string line;
-
-    // Skip header
-    if (!getline(file, line))
+    pageCounter = pageNumber + 1;
+    if (pageNumber < 0 || pageNumber >= pageCount)
     {
-        cerr << "ERROR: Cannot read header line from file" << endl;
-        file.close();
+        cout << "No more data to load." << endl;
         return false;
     }
 
-    // Skip lines until startLine
-    while (currentLine < startLine && getline(file, line))
-    {
-        currentLine++;
-    }
+    pageStream.clear();
+    pageStream.seekg(pageOffsets[pageNumber]);
 
     // Allocate memory for this page
     transactions = new Transaction[PAGE_SIZE];
     int validTransactions = 0;
-    string transaction_id, sender_account, receiver_account;
-    string transaction_type, location, payment_channel;
-    double amount;
+    int currentLine = 0;
+    string line;
+    string_view transaction_id, sender_account, receiver_account;
+    string_view transaction_type, location, payment_channel;
+    Amount amount;
     bool is_fraud;
 
-    // Load up to PAGE_SIZE transactions
-    while (currentLine < endLine && getline(file, line))
+    // A page is exactly PAGE_SIZE physical lines, matching the offsets in the index
+    while (currentLine < PAGE_SIZE && getline(pageStream, line))
     {
+        currentLine++;
         if (line.empty() || line.length() < 10)
             continue;
         CSVParser::ParseResult result = parseLineWithValidation(line, transaction_id, sender_account, receiver_account, amount, transaction_type, location, payment_channel, is_fraud);
-        if (result == ParseResult::SUCCESS)
+        if (result == ParseResult::SUCCESS &&
+            transactions[validTransactions].assign(transaction_id, sender_account, receiver_account, amount, transaction_type, location, payment_channel, is_fraud))
         {
-            transactions[validTransactions] = Transaction(transaction_id, sender_account, receiver_account, amount, transaction_type, location, payment_channel, is_fraud);
             validTransactions++;
         }
-        currentLine++;
     }
     numTransactions = validTransactions;
-    file.close();
-    pageCounter++;
     if (numTransactions == 0)
     {
         cout << "No more data to load." << endl;
         return false;
     }
-  
+
     return true;
 }
 
+int CSVParser::getPageCount()
+{
+    if (filePath.empty() || !ensurePageIndex(numeric_limits<int>::max()))
+        return 0;
+    return pageCount;
+}
+
+void CSVParser::resetPageIndex()
+{
+    if (pageStream.is_open())
+    {
+        pageStream.close();
+    }
+    delete[] pageOffsets;
+    pageOffsets = nullptr;
+    pageCount = 0;
+    pageOffsetsCapacity = 0;
+    pageIndexComplete = false;
+    indexScanOffset = 0;
+    indexRowsScanned = -1;
+}
+
+void CSVParser::appendPageOffset(long long offset)
+{
+    if (pageCount == pageOffsetsCapacity)
+    {
+        int newCapacity = pageOffsetsCapacity == 0 ? 64 : pageOffsetsCapacity * 2;
+        long long *grown = new long long[newCapacity];
+        for (int i = 0; i < pageCount; i++)
+            grown[i] = pageOffsets[i];
+        delete[] pageOffsets;
+        pageOffsets = grown;
+        pageOffsetsCapacity = newCapacity;
+    }
+    pageOffsets[pageCount++] = offset;
+}
+
+string CSVParser::getPageIndexPath() const
+{
+    return filePath + ".pageidx";
+}
+
+// Makes sure the index covers targetPage (or the whole file); scanning resumes where it
+// stopped last time, so every byte of the file is scanned at most once
+bool CSVParser::ensurePageIndex(int targetPage)
+{
+    if (!pageStream.is_open())
+    {
+        // Binary mode so the stored offsets are exact byte positions on every platform
+        pageStream.open(filePath, ios::binary);
+        if (!pageStream.is_open())
+        {
+            cerr << "   ERROR: Cannot open file " << filePath << endl;
+            return false;
+        }
+    }
+
+    if (pageIndexComplete || pageCount > targetPage)
+        return true;
+
+    error_code ec;
+    long long fileSize = static_cast<long long>(filesystem::file_size(filePath, ec));
+    if (ec || fileSize == 0)
+    {
+        cerr << "ERROR: Cannot read header line from file" << endl;
+        return false;
+    }
+    long long modifiedTime = static_cast<long long>(filesystem::last_write_time(filePath, ec).time_since_epoch().count());
+
+    // A fresh persisted index makes the scan unnecessary
+    if (pageCount == 0 && readPageIndexFile(fileSize, modifiedTime))
+        return true;
+
+    const int SCAN_BLOCK = 1 << 20;
+    char *block = new char[SCAN_BLOCK];
+    pageStream.clear();
+    pageStream.seekg(indexScanOffset);
+
+    while (!pageIndexComplete && pageCount <= targetPage)
+    {
+        long long blockStart = indexScanOffset;
+        pageStream.read(block, SCAN_BLOCK);
+        long long bytesRead = pageStream.gcount();
+        if (bytesRead <= 0)
+        {
+            pageIndexComplete = true;
+            break;
+        }
+
+        const char *cursor = block;
+        const char *blockEnd = block + bytesRead;
+        indexScanOffset = blockStart + bytesRead;
+        while (cursor < blockEnd)
+        {
+            const char *newline = static_cast<const char *>(memchr(cursor, '\n', blockEnd - cursor));
+            if (newline == nullptr)
+                break;
+            cursor = newline + 1;
+
+            // A newline ends a row; the first one ends the header
+            long long rowStart = blockStart + (cursor - block);
+            indexRowsScanned++;
+            if (indexRowsScanned % PAGE_SIZE == 0 && rowStart < fileSize)
+            {
+                appendPageOffset(rowStart);
+                if (pageCount > targetPage)
+                {
+                    // Resume right after this row next time
+                    indexScanOffset = rowStart;
+                    break;
+                }
+            }
+        }
+
+        if (indexScanOffset >= fileSize)
+            pageIndexComplete = true;
+    }
+    delete[] block;
+
+    if (pageIndexComplete)
+    {
+        if (indexRowsScanned < 0)
+        {
+            cerr << "ERROR: Cannot read header line from file" << endl;
+            return false;
+        }
+        writePageIndexFile(fileSize, modifiedTime);
+    }
+    return true;
+}
+
+// Index file layout: "PIDX", page size, CSV size, CSV mtime, page count, offsets
+bool CSVParser::readPageIndexFile(long long fileSize, long long modifiedTime)
+{
+    ifstream indexFile(getPageIndexPath(), ios::binary);
+    if (!indexFile.is_open())
+        return false;
+
+    char magic[4];
+    int storedPageSize = 0;
+    long long storedFileSize = 0, storedModifiedTime = 0;
+    int storedPageCount = 0;
+    indexFile.read(magic, sizeof(magic));
+    indexFile.read(reinterpret_cast<char *>(&storedPageSize), sizeof(storedPageSize));
+    indexFile.read(reinterpret_cast<char *>(&storedFileSize), sizeof(storedFileSize));
+    indexFile.read(reinterpret_cast<char *>(&storedModifiedTime), sizeof(storedModifiedTime));
+    indexFile.read(reinterpret_cast<char *>(&storedPageCount), sizeof(storedPageCount));
+    if (!indexFile || memcmp(magic, "PIDX", 4) != 0 || storedPageSize != PAGE_SIZE ||
+        storedFileSize != fileSize || storedModifiedTime != modifiedTime || storedPageCount < 0)
+    {
+        return false; // Missing, corrupt or stale: rebuild from the CSV
+    }
+
+    long long *offsets = new long long[storedPageCount > 0 ? storedPageCount : 1];
+    indexFile.read(reinterpret_cast<char *>(offsets), sizeof(long long) * storedPageCount);
+    if (!indexFile)
+    {
+        delete[] offsets;
+        return false;
+    }
+
+    delete[] pageOffsets;
+    pageOffsets = offsets;
+    pageCount = storedPageCount;
+    pageOffsetsCapacity = storedPageCount;
+    pageIndexComplete = true;
+    return true;
+}
+
+void CSVParser::writePageIndexFile(long long fileSize, long long modifiedTime) const
+{
+    // Best effort: a read-only data directory just means the index is rebuilt next run
+    ofstream indexFile(getPageIndexPath(), ios::binary | ios::trunc);
+    if (!indexFile.is_open())
+        return;
+
+    int storedPageSize = PAGE_SIZE;
+    indexFile.write("PIDX", 4);
+    indexFile.write(reinterpret_cast<const char *>(&storedPageSize), sizeof(storedPageSize));
+    indexFile.write(reinterpret_cast<const char *>(&fileSize), sizeof(fileSize));
+    indexFile.write(reinterpret_cast<const char *>(&modifiedTime), sizeof(modifiedTime));
+    indexFile.write(reinterpret_cast<const char *>(&pageCount), sizeof(pageCount));
+    indexFile.write(reinterpret_cast<const char *>(pageOffsets), sizeof(long long) * pageCount);
+}
+
 int CSVParser::getNumTransactions() { return numTransactions; }
 Transaction *CSVParser::getTransactions() { return transactions; }
 
+// Field boundaries come from the vectorized delimiter bitmaps in CSVTokenizer
+int CSVParser::splitFields(string_view line, string_view fields[], int maxFields)
+{
+    return CSVTokenizer::splitFields(line, fields, maxFields);
+}
+
+bool CSVParser::parseBoolField(string_view token)
+{
+    return token == "1" || token == "true" || token == "True" || token == "TRUE";
+}
+
+// Remove leading/trailing whitespace without copying
+static string_view trimField(string_view token)
+{
+    size_t first = token.find_first_not_of(" \t");
+    if (first == string_view::npos)
+        return string_view();
+    size_t last = token.find_last_not_of(" \t");
+    return token.substr(first, last - first + 1);
+}
+
+// Projection bit for a CSV field index (0 for columns the parser never uses)
+static unsigned columnForField(int index)
+{
+    switch (index)
+    {
+    case 0:
+        return CSVParser::COLUMN_TRANSACTION_ID;
+    case 2:
+        return CSVParser::COLUMN_SENDER_ACCOUNT;
+    case 3:
+        return CSVParser::COLUMN_RECEIVER_ACCOUNT;
+    case 4:
+        return CSVParser::COLUMN_AMOUNT;
+    case 5:
+        return CSVParser::COLUMN_TRANSACTION_TYPE;
+    case 7:
+        return CSVParser::COLUMN_LOCATION;
+    case 9:
+        return CSVParser::COLUMN_IS_FRAUD;
+    case 15:
+        return CSVParser::COLUMN_PAYMENT_CHANNEL;
+    default:
+        return 0;
+    }
+}
+
+// Highest CSV field index covered by a projection (-1 for none)
+static int lastFieldForColumns(unsigned columns)
+{
+    for (int index = 15; index >= 0; index--)
+    {
+        if (columns & columnForField(index))
+            return index;
+    }
+    return -1;
+}
+
 // Enhanced helper method to parse a single CSV line with detailed validation
-CSVParser::ParseResult CSVParser::parseLineWithValidation(const string &line, string &transaction_id,
-                                                          string &sender_account, string &receiver_account,
-                                                          double &amount, string &transaction_type,
-                                                          string &location, string &payment_channel,
-                                                          bool &is_fraud)
-{
-    stringstream ss(line);
-    string token;
-    int index = 0;
-    int tokenCount = 0;
-
-    // Reset values
-    amount = 0;
+CSVParser::ParseResult CSVParser::parseLineWithValidation(string_view line, string_view &transaction_id,
+                                                          string_view &sender_account, string_view &receiver_account,
+                                                          Amount &amount, string_view &transaction_type,
+                                                          string_view &location, string_view &payment_channel,
+                                                          bool &is_fraud) const
+{
+    string_view fields[MAX_FIELDS];
+    int tokenCount = splitFields(line, fields, MAX_FIELDS);
+    return parseFieldsWithValidation(fields, tokenCount, ALL_COLUMNS, transaction_id, sender_account, receiver_account,
+                                     amount, transaction_type, location, payment_channel, is_fraud);
+}
+
+// Validation and conversion of an already split line
+CSVParser::ParseResult CSVParser::parseFieldsWithValidation(const string_view fields[], int tokenCount,
+                                                            unsigned columns, string_view &transaction_id, string_view &sender_account,
+                                                            string_view &receiver_account, Amount &amount,
+                                                            string_view &transaction_type, string_view &location,
+                                                            string_view &payment_channel, bool &is_fraud) const
+{
+    // Reset values; text fields are views into the line, so nothing is copied
+    amount = Amount();
     is_fraud = false;
-    transaction_id.clear();
-    sender_account.clear();
-    receiver_account.clear();
-    transaction_type.clear();
-    location.clear();
-    payment_channel.clear();
+    transaction_id = string_view();
+    sender_account = string_view();
+    receiver_account = string_view();
+    transaction_type = string_view();
+    location = string_view();
+    payment_channel = string_view();
 
-    while (getline(ss, token, ','))
+    for (int index = 0; index < tokenCount; index++)
     {
-        tokenCount++;
+        // Columns outside the projection are never trimmed or validated
+        unsigned column = columnForField(index);
+        if ((columns & column) == 0)
+            continue;
 
-        // Remove leading/trailing whitespace
-        token.erase(0, token.find_first_not_of(" \t"));
-        token.erase(token.find_last_not_of(" \t") + 1);
+        string_view token = trimField(fields[index]);
 
         switch (index)
         {
@@ -153,21 +407,13 @@ CSVParser::ParseResult CSVParser::parseLineWithValidation(const string &line, st
             }
             break;
         case 4:
-            try
-            {
-                amount = stod(token);
-                if (amount < 0 || amount > 1000000)
-                { // Reasonable range check
-                    return ParseResult::VALIDATION_ERROR;
-                }
-            }
-            catch (const invalid_argument &)
+            if (!Amount::parse(token, amount))
             {
                 return ParseResult::PARSE_ERROR;
             }
-            catch (const out_of_range &)
-            {
-                return ParseResult::PARSE_ERROR;
+            if (amount.getMicros() < 0 || amount.getMicros() > 1000000 * Amount::MICROS_PER_UNIT)
+            { // Reasonable range check
+                return ParseResult::VALIDATION_ERROR;
             }
             break;
         case 5:
@@ -185,7 +431,7 @@ CSVParser::ParseResult CSVParser::parseLineWithValidation(const string &line, st
             }
             break;
         case 9:
-            is_fraud = (token == "1" || token == "true" || token == "True" || token == "TRUE");
+            is_fraud = parseBoolField(token);
             break;
         case 15:
             payment_channel = token;
@@ -195,29 +441,29 @@ CSVParser::ParseResult CSVParser::parseLineWithValidation(const string &line, st
             }
             break;
         }
-        index++;
-
-        if (index > 16)
-            break; // Prevent excessive parsing
     }
 
-    // Check if we have minimum required tokens
-    if (tokenCount < 16)
+    // Check if we have minimum required tokens (up to the last requested column)
+    if (tokenCount < lastFieldForColumns(columns) + 1)
     {
         return ParseResult::MALFORMED;
     }
 
     // Validate required fields are not empty and have valid content
-    if (transaction_id.empty() || sender_account.empty() ||
-        receiver_account.empty() || amount <= 0 ||
-        transaction_type.empty() || location.empty() ||
-        payment_channel.empty())
+    if (((columns & COLUMN_TRANSACTION_ID) && transaction_id.empty()) ||
+        ((columns & COLUMN_SENDER_ACCOUNT) && sender_account.empty()) ||
+        ((columns & COLUMN_RECEIVER_ACCOUNT) && receiver_account.empty()) ||
+        ((columns & COLUMN_AMOUNT) && amount.getMicros() <= 0) ||
+        ((columns & COLUMN_TRANSACTION_TYPE) && transaction_type.empty()) ||
+        ((columns & COLUMN_LOCATION) && location.empty()) ||
+        ((columns & COLUMN_PAYMENT_CHANNEL) && payment_channel.empty()))
     {
         return ParseResult::VALIDATION_ERROR;
     }
 
     // Additional business logic validation
-    if (sender_account == receiver_account)
+    if ((columns & COLUMN_SENDER_ACCOUNT) && (columns & COLUMN_RECEIVER_ACCOUNT) &&
+        sender_account == receiver_account)
     {
         return ParseResult::VALIDATION_ERROR; // Same sender and receiver
     }
@@ -230,8 +476,18 @@ bool CSVParser::parseLine(const string &line, string &transaction_id, string &se
                           string &receiver_account, double &amount, string &transaction_type,
                           string &location, string &payment_channel, bool &is_fraud)
 {
-    return parseLineWithValidation(line, transaction_id, sender_account, receiver_account,
-                                   amount, transaction_type, location, payment_channel, is_fraud) == ParseResult::SUCCESS;
+    string_view idView, senderView, receiverView, typeView, locationView, channelView;
+    Amount exactAmount;
+    ParseResult result = parseLineWithValidation(line, idView, senderView, receiverView,
+                                                 exactAmount, typeView, locationView, channelView, is_fraud);
+    amount = exactAmount.toDouble();
+    transaction_id.assign(idView);
+    sender_account.assign(senderView);
+    receiver_account.assign(receiverView);
+    transaction_type.assign(typeView);
+    location.assign(locationView);
+    payment_channel.assign(channelView);
+    return result == ParseResult::SUCCESS;
 }
 
 // Streaming methods for low memory usage
@@ -243,6 +499,41 @@ bool CSVParser::initializeStreaming()
         return false;
     }
 
+    // Fastest path: a snapshot of this exact CSV replaces the text parse entirely
+    if (useSnapshot && projection == ALL_COLUMNS && openFreshSnapshot())
+    {
+        snapshotRow = 0;
+        isStreamMode = true;
+        totalProcessed = 0;
+        parseStats = ParseStats();
+        parseStats.parseErrors = snapshot.getSourceStats().parseErrors;
+        parseStats.validationErrors = snapshot.getSourceStats().validationErrors;
+        parseStats.malformed = snapshot.getSourceStats().malformed;
+        return true;
+    }
+
+    // Preferred text path: map the whole file and walk it with pointers
+    if (useMemoryMap && mappedFile.open(filePath))
+    {
+        mapCursor = mappedFile.data();
+        mapEnd = mapCursor + mappedFile.size();
+
+        // Skip header line
+        string_view headerLine;
+        if (!readNextLine(headerLine))
+        {
+            cerr << "ERROR: Cannot read header line for streaming" << endl;
+            mappedFile.close();
+            return false;
+        }
+
+        isStreamMode = true;
+        totalProcessed = 0;
+        parseStats = ParseStats();
+        cout << "Might Take Seconds To Process Please Wait" << endl;
+        return true;
+    }
+
     fileStream.open(filePath);
     if (!fileStream.is_open())
     {
@@ -260,42 +551,121 @@ bool CSVParser::initializeStreaming()
 
     isStreamMode = true;
     totalProcessed = 0;
+    parseStats = ParseStats();
     cout << "Might Take Seconds To Process Please Wait" << endl;
     return true;
 }
 
-bool CSVParser::getNextTransaction(Transaction &transaction)
+// Cuts the line starting at cursor out of [cursor, end) and advances past its newline
+static bool nextLineInRange(const char *&cursor, const char *end, string_view &line)
 {
-    if (!isStreamMode || !fileStream.is_open())
+    if (cursor >= end)
+        return false;
+
+    const char *lineEnd = static_cast<const char *>(memchr(cursor, '\n', end - cursor));
+    if (lineEnd == nullptr)
+        lineEnd = end;
+
+    line = string_view(cursor, lineEnd - cursor);
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    cursor = (lineEnd < end) ? lineEnd + 1 : end;
+    return true;
+}
+
+// Returns the next raw line; for mapped files the view points straight into the mapping
+bool CSVParser::readNextLine(string_view &line)
+{
+    if (mappedFile.isOpen())
     {
+        return nextLineInRange(mapCursor, mapEnd, line);
+    }
+
+    if (!fileStream.is_open() || !getline(fileStream, lineBuffer))
         return false;
+
+    line = lineBuffer;
+    return true;
+}
+
+bool CSVParser::getNextTransaction(Transaction &transaction)
+{
+    return getNextBatch(&transaction, 1) == 1;
+}
+
+// The scan loop fills the caller's rows directly: the mode checks run once per batch, not once
+// per row, and each row is parsed straight into its slot
+int CSVParser::getNextBatch(Transaction batch[], int batchSize)
+{
+    if (!isStreamMode)
+    {
+        return 0;
     }
 
-    string line;
-    while (getline(fileStream, line))
+    int filled = 0;
+    if (snapshot.isOpen())
+    {
+        long long rowCount = snapshot.getRowCount();
+        while (filled < batchSize && snapshotRow < rowCount)
+        {
+            long long row = snapshotRow++;
+            if (hasFilter && !matchesSnapshotFilter(row))
+            {
+                parseStats.filteredOut++;
+                continue;
+            }
+            if (!readSnapshotRow(row, batch[filled]))
+            {
+                parseStats.validationErrors++;
+                continue;
+            }
+            parseStats.success++;
+            filled++;
+        }
+        totalProcessed += filled;
+        return filled;
+    }
+
+    string_view line;
+    string_view fields[MAX_FIELDS];
+    while (filled < batchSize && readNextLine(line))
     {
         if (line.empty() || line.length() < 10)
             continue;
 
-        string transaction_id, sender_account, receiver_account;
-        string transaction_type, location, payment_channel;
-        double amount;
+        int tokenCount = splitFields(line, fields, splitLimit);
+        if (hasFilter && !matchesFilter(fields, tokenCount))
+        {
+            parseStats.filteredOut++;
+            continue;
+        }
+
+        string_view transaction_id, sender_account, receiver_account;
+        string_view transaction_type, location, payment_channel;
+        Amount amount;
         bool is_fraud;
 
-        ParseResult result = parseLineWithValidation(line, transaction_id, sender_account,
-                                                     receiver_account, amount, transaction_type,
-                                                     location, payment_channel, is_fraud);
+        ParseResult result = parseFieldsWithValidation(fields, tokenCount, projection, transaction_id, sender_account,
+                                                       receiver_account, amount, transaction_type,
+                                                       location, payment_channel, is_fraud);
+        // A value that no longer fits its dictionary is rejected like any invalid value
+        if (result == ParseResult::SUCCESS &&
+            !batch[filled].assign(transaction_id, sender_account, receiver_account,
+                                  amount, transaction_type, location, payment_channel, is_fraud))
+        {
+            result = ParseResult::VALIDATION_ERROR;
+        }
+        parseStats.record(result);
 
         if (result == ParseResult::SUCCESS)
         {
-            transaction = Transaction(transaction_id, sender_account, receiver_account,
-                                      amount, transaction_type, location, payment_channel, is_fraud);
-            totalProcessed++;
-            return true;
+            filled++;
         }
     }
 
-    return false; // End of file or no more valid transactions
+    totalProcessed += filled;
+    return filled; // Short only at end of file
 }
 
 void CSVParser::closeStream()
@@ -304,6 +674,10 @@ void CSVParser::closeStream()
     {
         fileStream.close();
     }
+    mappedFile.close();
+    snapshot.close();
+    mapCursor = nullptr;
+    mapEnd = nullptr;
     isStreamMode = false;
     cout << "Streaming mode closed. Total processed: " << totalProcessed << endl;
 }
@@ -311,4 +685,523 @@ void CSVParser::closeStream()
 long long CSVParser::getTotalProcessed() const
 {
     return totalProcessed;
-}
\ No newline at end of file
+}
+
+void CSVParser::setMemoryMapping(bool enabled)
+{
+    useMemoryMap = enabled;
+}
+
+bool CSVParser::isMemoryMapped() const
+{
+    return mappedFile.isOpen();
+}
+
+template <typename Output>
+bool CSVParser::loadFilteredInto(const TransactionFilter &rowFilter, Output &output)
+{
+    // The caller's filter only applies to this pass
+    TransactionFilter previousFilter = filter;
+    bool hadFilter = hasFilter;
+    setFilter(rowFilter);
+
+    bool opened = initializeStreaming();
+    if (opened)
+    {
+        const int BATCH_SIZE = 256;
+        Transaction *batch = new Transaction[BATCH_SIZE];
+        int filled;
+        while ((filled = getNextBatch(batch, BATCH_SIZE)) > 0)
+        {
+            output.appendBatch(batch, filled);
+        }
+        delete[] batch;
+        closeStream();
+    }
+
+    if (hadFilter)
+        setFilter(previousFilter);
+    else
+        clearFilter();
+    return opened;
+}
+
+bool CSVParser::loadFilteredTransactions(const TransactionFilter &rowFilter, TransactionBuffer &output)
+{
+    return loadFilteredInto(rowFilter, output);
+}
+
+bool CSVParser::loadFilteredTransactions(const TransactionFilter &rowFilter, TransactionTable &output)
+{
+    return loadFilteredInto(rowFilter, output);
+}
+
+bool CSVParser::loadFilteredTransactions(const TransactionFilter &rowFilter, TopKByChannel &output)
+{
+    bool opened = loadFilteredInto(rowFilter, output);
+    output.finish();
+    return opened;
+}
+
+bool CSVParser::loadMatchingTransactions(const string &transactionType, TransactionBuffer &output)
+{
+    TransactionFilter typeFilter;
+    typeFilter.transactionType = transactionType;
+    return loadFilteredTransactions(typeFilter, output);
+}
+
+bool CSVParser::loadMatchingTransactions(const string &transactionType, TransactionTable &output)
+{
+    TransactionFilter typeFilter;
+    typeFilter.transactionType = transactionType;
+    return loadFilteredTransactions(typeFilter, output);
+}
+
+bool CSVParser::loadMatchingTransactions(const string &transactionType, TopKByChannel &output)
+{
+    TransactionFilter typeFilter;
+    typeFilter.transactionType = transactionType;
+    return loadFilteredTransactions(typeFilter, output);
+}
+
+void CSVParser::setFilter(const TransactionFilter &rowFilter)
+{
+    filter = rowFilter;
+    hasFilter = !rowFilter.isEmpty();
+    updateSplitLimit();
+}
+
+void CSVParser::clearFilter()
+{
+    filter = TransactionFilter();
+    hasFilter = false;
+    updateSplitLimit();
+}
+
+void CSVParser::setProjection(unsigned columns)
+{
+    projection = columns & ALL_COLUMNS;
+    updateSplitLimit();
+}
+
+unsigned CSVParser::getProjection() const
+{
+    return projection;
+}
+
+// Splitting stops after the last field that the projection or the filter looks at
+void CSVParser::updateSplitLimit()
+{
+    unsigned neededColumns = projection;
+    if (hasFilter)
+    {
+        if (!filter.transactionType.empty())
+            neededColumns |= COLUMN_TRANSACTION_TYPE;
+        if (!filter.paymentChannel.empty())
+            neededColumns |= COLUMN_PAYMENT_CHANNEL;
+        if (filter.fraudFlag != TransactionFilter::FraudFlag::ANY)
+            neededColumns |= COLUMN_IS_FRAUD;
+        if (filter.hasAmountRange())
+            neededColumns |= COLUMN_AMOUNT;
+    }
+    splitLimit = lastFieldForColumns(neededColumns) + 1;
+}
+
+// Cheap checks first; the amount is only converted when a range was requested
+bool CSVParser::matchesFilter(const string_view fields[], int tokenCount) const
+{
+    if (!filter.transactionType.empty() &&
+        (tokenCount <= 5 || trimField(fields[5]) != filter.transactionType))
+        return false;
+
+    if (!filter.paymentChannel.empty() &&
+        (tokenCount <= 15 || trimField(fields[15]) != filter.paymentChannel))
+        return false;
+
+    if (filter.fraudFlag != TransactionFilter::FraudFlag::ANY)
+    {
+        bool isFraud = tokenCount > 9 && parseBoolField(trimField(fields[9]));
+        if (isFraud != (filter.fraudFlag == TransactionFilter::FraudFlag::FRAUD_ONLY))
+            return false;
+    }
+
+    if (filter.hasAmountRange())
+    {
+        Amount amount;
+        if (tokenCount <= 4 || !Amount::parse(trimField(fields[4]), amount) ||
+            amount.toDouble() < filter.minAmount || amount.toDouble() > filter.maxAmount)
+            return false;
+    }
+
+    return true;
+}
+
+bool CSVParser::TransactionFilter::hasAmountRange() const
+{
+    return minAmount != -numeric_limits<double>::infinity() || maxAmount != numeric_limits<double>::infinity();
+}
+
+bool CSVParser::TransactionFilter::isEmpty() const
+{
+    return transactionType.empty() && paymentChannel.empty() && fraudFlag == FraudFlag::ANY && !hasAmountRange();
+}
+
+bool CSVParser::getSourceVersion(long long &fileSize, long long &modifiedTime) const
+{
+    error_code ec;
+    fileSize = static_cast<long long>(filesystem::file_size(filePath, ec));
+    if (ec)
+        return false;
+    modifiedTime = static_cast<long long>(filesystem::last_write_time(filePath, ec).time_since_epoch().count());
+    return !ec;
+}
+
+bool CSVParser::openFreshSnapshot()
+{
+    long long fileSize, modifiedTime;
+    return getSourceVersion(fileSize, modifiedTime) &&
+           snapshot.open(ColumnarSnapshot::pathFor(filePath), fileSize, modifiedTime);
+}
+
+bool CSVParser::hasFreshSnapshot() const
+{
+    long long fileSize, modifiedTime;
+    ColumnarSnapshot probe;
+    return getSourceVersion(fileSize, modifiedTime) &&
+           probe.open(ColumnarSnapshot::pathFor(filePath), fileSize, modifiedTime);
+}
+
+void CSVParser::setSnapshotUse(bool enabled)
+{
+    useSnapshot = enabled;
+}
+
+// Streams the CSV text once with full validation and writes every valid row to the snapshot
+bool CSVParser::buildSnapshot()
+{
+    long long fileSize, modifiedTime;
+    if (filePath.empty() || !getSourceVersion(fileSize, modifiedTime))
+    {
+        cerr << "ERROR: Cannot read file for snapshot: " << filePath << endl;
+        return false;
+    }
+
+    // The snapshot must hold every valid row, whatever the caller has configured
+    TransactionFilter previousFilter = filter;
+    bool hadFilter = hasFilter;
+    unsigned previousProjection = projection;
+    bool previousUseSnapshot = useSnapshot;
+    clearFilter();
+    setProjection(ALL_COLUMNS);
+    useSnapshot = false;
+
+    ColumnarSnapshot::Writer writer;
+    bool complete = initializeStreaming();
+    if (complete)
+    {
+        const int BATCH_SIZE = 256;
+        Transaction *batch = new Transaction[BATCH_SIZE];
+        int filled;
+        while (complete && (filled = getNextBatch(batch, BATCH_SIZE)) > 0)
+        {
+            for (int i = 0; i < filled; i++)
+            {
+                if (!writer.addRow(batch[i]))
+                {
+                    cerr << "ERROR: Too many distinct categorical values for a snapshot" << endl;
+                    complete = false;
+                    break;
+                }
+            }
+        }
+        delete[] batch;
+        closeStream();
+    }
+
+    ColumnarSnapshot::SourceStats stats;
+    stats.parseErrors = parseStats.parseErrors;
+    stats.validationErrors = parseStats.validationErrors;
+    stats.malformed = parseStats.malformed;
+
+    if (hadFilter)
+        setFilter(previousFilter);
+    else
+        clearFilter();
+    setProjection(previousProjection);
+    useSnapshot = previousUseSnapshot;
+
+    return complete && writer.write(ColumnarSnapshot::pathFor(filePath), fileSize, modifiedTime, stats);
+}
+
+bool CSVParser::matchesSnapshotFilter(long long row) const
+{
+    if (!filter.transactionType.empty() &&
+        snapshot.getCategory(ColumnarSnapshot::TRANSACTION_TYPE_COLUMN, row) != filter.transactionType)
+        return false;
+
+    if (!filter.paymentChannel.empty() &&
+        snapshot.getCategory(ColumnarSnapshot::PAYMENT_CHANNEL_COLUMN, row) != filter.paymentChannel)
+        return false;
+
+    if (filter.fraudFlag != TransactionFilter::FraudFlag::ANY &&
+        snapshot.getIsFraud(row) != (filter.fraudFlag == TransactionFilter::FraudFlag::FRAUD_ONLY))
+        return false;
+
+    double amount = Amount::fromMicros(snapshot.getAmountMicros(row)).toDouble();
+    return amount >= filter.minAmount && amount <= filter.maxAmount;
+}
+
+bool CSVParser::readSnapshotRow(long long row, Transaction &transaction) const
+{
+    return transaction.assignEncoded(snapshot.getId(ColumnarSnapshot::TRANSACTION_ID_COLUMN, row),
+                                     snapshot.getId(ColumnarSnapshot::SENDER_ACCOUNT_COLUMN, row),
+                                     snapshot.getId(ColumnarSnapshot::RECEIVER_ACCOUNT_COLUMN, row),
+                                     Amount::fromMicros(snapshot.getAmountMicros(row)),
+                                     snapshot.getCategoryCode(ColumnarSnapshot::TRANSACTION_TYPE_COLUMN, row),
+                                     snapshot.getCategoryCode(ColumnarSnapshot::LOCATION_COLUMN, row),
+                                     snapshot.getCategoryCode(ColumnarSnapshot::PAYMENT_CHANNEL_COLUMN, row),
+                                     snapshot.getIsFraud(row));
+}
+
+const CSVParser::ParseStats &CSVParser::getParseStats() const
+{
+    return parseStats;
+}
+
+void CSVParser::ParseStats::record(ParseResult result)
+{
+    switch (result)
+    {
+    case ParseResult::SUCCESS:
+        success++;
+        break;
+    case ParseResult::PARSE_ERROR:
+        parseErrors++;
+        break;
+    case ParseResult::VALIDATION_ERROR:
+        validationErrors++;
+        break;
+    case ParseResult::MALFORMED:
+        malformed++;
+        break;
+    }
+}
+
+void CSVParser::ParseStats::merge(const ParseStats &other)
+{
+    success += other.success;
+    parseErrors += other.parseErrors;
+    validationErrors += other.validationErrors;
+    malformed += other.malformed;
+    filteredOut += other.filteredOut;
+}
+
+// Thread-local output of one worker; grows by doubling and moves rows on growth
+struct CSVParser::ParsedChunk
+{
+    Transaction *rows = nullptr;
+    long long count = 0;
+    long long capacity = 0;
+    ParseStats stats;
+
+    ~ParsedChunk() { delete[] rows; }
+
+    void append(Transaction &&transaction)
+    {
+        if (count == capacity)
+        {
+            long long newCapacity = capacity == 0 ? 1024 : capacity * 2;
+            Transaction *grown = new Transaction[newCapacity];
+            for (long long i = 0; i < count; i++)
+                grown[i] = std::move(rows[i]);
+            delete[] rows;
+            rows = grown;
+            capacity = newCapacity;
+        }
+        rows[count++] = std::move(transaction);
+    }
+};
+
+// Worker body: same line filter, validation and accounting as getNextBatch
+void CSVParser::parseRange(const char *begin, const char *end, ParsedChunk &chunk) const
+{
+    string_view transaction_id, sender_account, receiver_account;
+    string_view transaction_type, location, payment_channel;
+    Amount amount;
+    bool is_fraud;
+    Transaction row;
+
+    string_view line;
+    const char *cursor = begin;
+    while (nextLineInRange(cursor, end, line))
+    {
+        if (line.empty() || line.length() < 10)
+            continue;
+
+        string_view fields[MAX_FIELDS];
+        int tokenCount = splitFields(line, fields, splitLimit);
+        if (hasFilter && !matchesFilter(fields, tokenCount))
+        {
+            chunk.stats.filteredOut++;
+            continue;
+        }
+
+        ParseResult result = parseFieldsWithValidation(fields, tokenCount, projection, transaction_id, sender_account,
+                                                       receiver_account, amount, transaction_type, location,
+                                                       payment_channel, is_fraud);
+        if (result == ParseResult::SUCCESS &&
+            !row.assign(transaction_id, sender_account, receiver_account, amount,
+                        transaction_type, location, payment_channel, is_fraud))
+        {
+            result = ParseResult::VALIDATION_ERROR;
+        }
+        chunk.stats.record(result);
+        if (result == ParseResult::SUCCESS)
+        {
+            chunk.append(std::move(row));
+        }
+    }
+}
+
+Transaction *CSVParser::parseAllParallel(long long &count, int threadCount)
+{
+    count = 0;
+    parseStats = ParseStats();
+    if (filePath.empty())
+    {
+        cerr << "ERROR: No file path set for parallel parsing." << endl;
+        return nullptr;
+    }
+
+    // A fresh snapshot needs no parsing at all: count the matches, then copy them out
+    if (useSnapshot && projection == ALL_COLUMNS && openFreshSnapshot())
+    {
+        long long rowCount = snapshot.getRowCount();
+        for (long long row = 0; row < rowCount; row++)
+        {
+            if (!hasFilter || matchesSnapshotFilter(row))
+                count++;
+        }
+
+        Transaction *result = new Transaction[count > 0 ? count : 1];
+        long long next = 0;
+        long long rejected = 0;
+        for (long long row = 0; row < rowCount; row++)
+        {
+            if (!hasFilter || matchesSnapshotFilter(row))
+            {
+                if (readSnapshotRow(row, result[next]))
+                    next++;
+                else
+                    rejected++;
+            }
+        }
+
+        parseStats.success = next;
+        parseStats.filteredOut = rowCount - count;
+        parseStats.parseErrors = snapshot.getSourceStats().parseErrors;
+        parseStats.validationErrors = snapshot.getSourceStats().validationErrors + rejected;
+        parseStats.malformed = snapshot.getSourceStats().malformed;
+        snapshot.close();
+        count = next;
+        totalProcessed = count;
+        return result;
+    }
+
+    if (threadCount <= 0)
+        threadCount = static_cast<int>(thread::hardware_concurrency());
+    if (threadCount <= 0)
+        threadCount = 1;
+
+    MappedFile file;
+    ParsedChunk *chunks = nullptr;
+    int chunkCount = 0;
+
+    if (useMemoryMap && file.open(filePath))
+    {
+        const char *data = file.data();
+        const char *fileEnd = data + file.size();
+
+        // Skip header line
+        const char *bodyStart = static_cast<const char *>(memchr(data, '\n', file.size()));
+        bodyStart = (bodyStart == nullptr) ? fileEnd : bodyStart + 1;
+
+        // Cut the body into roughly equal byte ranges, moving every cut forward to the
+        // start of the next line so no row is split between two workers
+        long long bodySize = fileEnd - bodyStart;
+        if (bodySize < static_cast<long long>(threadCount) * 64 * 1024)
+            threadCount = 1; // Not worth spinning up threads for small files
+
+        const char **bounds = new const char *[threadCount + 1];
+        bounds[0] = bodyStart;
+        for (int t = 1; t < threadCount; t++)
+        {
+            const char *cut = bodyStart + bodySize * t / threadCount;
+            if (cut < bounds[t - 1])
+                cut = bounds[t - 1];
+            if (cut > bodyStart && cut < fileEnd && cut[-1] != '\n')
+            {
+                const char *newline = static_cast<const char *>(memchr(cut, '\n', fileEnd - cut));
+                cut = (newline == nullptr) ? fileEnd : newline + 1;
+            }
+            bounds[t] = cut;
+        }
+        bounds[threadCount] = fileEnd;
+
+        chunkCount = threadCount;
+        chunks = new ParsedChunk[chunkCount];
+        thread *workers = new thread[threadCount];
+        for (int t = 0; t < threadCount; t++)
+        {
+            workers[t] = thread(&CSVParser::parseRange, this, bounds[t], bounds[t + 1], ref(chunks[t]));
+        }
+        for (int t = 0; t < threadCount; t++)
+        {
+            workers[t].join();
+        }
+        delete[] workers;
+        delete[] bounds;
+    }
+    else
+    {
+        // No mapping available: fall back to one serial pass through the stream reader
+        chunkCount = 1;
+        chunks = new ParsedChunk[1];
+        if (!initializeStreaming())
+        {
+            delete[] chunks;
+            return nullptr;
+        }
+        const int BATCH_SIZE = 256;
+        Transaction *batch = new Transaction[BATCH_SIZE];
+        int filled;
+        while ((filled = getNextBatch(batch, BATCH_SIZE)) > 0)
+        {
+            for (int i = 0; i < filled; i++)
+                chunks[0].append(std::move(batch[i]));
+        }
+        delete[] batch;
+        chunks[0].stats = parseStats;
+        closeStream();
+        parseStats = ParseStats();
+    }
+
+    // Concatenate the worker buffers in file order
+    for (int c = 0; c < chunkCount; c++)
+    {
+        count += chunks[c].count;
+        parseStats.merge(chunks[c].stats);
+    }
+
+    Transaction *result = new Transaction[count > 0 ? count : 1];
+    long long next = 0;
+    for (int c = 0; c < chunkCount; c++)
+    {
+        for (long long i = 0; i < chunks[c].count; i++)
+            result[next++] = std::move(chunks[c].rows[i]);
+    }
+    delete[] chunks;
+
+    totalProcessed = count;
+    return result;
+}
@@ -0,0 +1,191 @@
+#include "../include/CSVTokenizer.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CSV_TOKENIZER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+typedef uint64_t (*MaskFunction)(const char *block);
+
+static uint64_t delimiterMaskScalar(const char *block)
+{
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        mask |= static_cast<uint64_t>(block[i] == ',') << i;
+    }
+    return mask;
+}
+
+#ifdef CSV_TOKENIZER_X86
+// SSE2 is part of the x86-64 baseline, so this needs no runtime check
+static uint64_t delimiterMaskSSE2(const char *block)
+{
+    const __m128i comma = _mm_set1_epi8(',');
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16 * i));
+        uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, comma)));
+        mask |= static_cast<uint64_t>(bits) << (16 * i);
+    }
+    return mask;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+static uint64_t delimiterMaskAVX2(const char *block)
+{
+    const __m256i comma = _mm256_set1_epi8(',');
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+    uint32_t lowBits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, comma)));
+    uint32_t highBits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, comma)));
+    return static_cast<uint64_t>(lowBits) | (static_cast<uint64_t>(highBits) << 32);
+}
+
+static bool cpuHasAVX2()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 &&
+                      (_xgetbv(0) & 6) == 6;
+    if (!osSavesYmm)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+#endif
+
+static inline int lowestSetBit(uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    int index = 0;
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+static MaskFunction maskFunctionFor(CSVTokenizer::InstructionSet instructionSet)
+{
+#ifdef CSV_TOKENIZER_X86
+    if (instructionSet == CSVTokenizer::InstructionSet::AVX2)
+        return delimiterMaskAVX2;
+    if (instructionSet == CSVTokenizer::InstructionSet::SSE2)
+        return delimiterMaskSSE2;
+#endif
+    return delimiterMaskScalar;
+}
+
+static CSVTokenizer::InstructionSet detectInstructionSet()
+{
+#ifdef CSV_TOKENIZER_X86
+    return cpuHasAVX2() ? CSVTokenizer::InstructionSet::AVX2 : CSVTokenizer::InstructionSet::SSE2;
+#else
+    return CSVTokenizer::InstructionSet::SCALAR;
+#endif
+}
+
+// Dispatch is decided once at startup
+static CSVTokenizer::InstructionSet activeInstructionSet = detectInstructionSet();
+static MaskFunction activeMaskFunction = maskFunctionFor(activeInstructionSet);
+
+int CSVTokenizer::splitFields(string_view line, string_view fields[], int maxFields)
+{
+    if (maxFields <= 0)
+        return 0;
+
+    MaskFunction maskFunction = activeMaskFunction;
+    const char *data = line.data();
+    size_t size = line.size();
+    size_t fieldStart = 0;
+    int count = 0;
+
+    for (size_t blockStart = 0; blockStart < size; blockStart += 64)
+    {
+        uint64_t mask;
+        if (size - blockStart >= 64)
+        {
+            mask = maskFunction(data + blockStart);
+        }
+        else
+        {
+            // Never read past the end of the line: it may be the last bytes of a mapping
+            char tail[64] = {};
+            memcpy(tail, data + blockStart, size - blockStart);
+            mask = maskFunction(tail);
+        }
+
+        while (mask != 0)
+        {
+            size_t comma = blockStart + lowestSetBit(mask);
+            mask &= mask - 1;
+            fields[count++] = line.substr(fieldStart, comma - fieldStart);
+            fieldStart = comma + 1;
+            if (count == maxFields)
+                return count;
+        }
+    }
+
+    if (fieldStart < size)
+        fields[count++] = line.substr(fieldStart);
+    return count;
+}
+
+uint64_t CSVTokenizer::delimiterMask(const char *block)
+{
+    return activeMaskFunction(block);
+}
+
+CSVTokenizer::InstructionSet CSVTokenizer::getInstructionSet()
+{
+    return activeInstructionSet;
+}
+
+bool CSVTokenizer::isSupported(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case InstructionSet::SCALAR:
+        return true;
+#ifdef CSV_TOKENIZER_X86
+    case InstructionSet::SSE2:
+        return true;
+    case InstructionSet::AVX2:
+        return cpuHasAVX2();
+#endif
+    default:
+        return false;
+    }
+}
+
+bool CSVTokenizer::setInstructionSet(InstructionSet instructionSet)
+{
+    if (!isSupported(instructionSet))
+        return false;
+    activeInstructionSet = instructionSet;
+    activeMaskFunction = maskFunctionFor(instructionSet);
+    return true;
+}
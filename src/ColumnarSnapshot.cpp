@@ -0,0 +1,529 @@
+#include "../include/ColumnarSnapshot.hpp"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+// File layout: a fixed header (magic, row count, source CSV version, source parse stats and one
+// descriptor per column) followed by 8-byte aligned column sections in schema order.
+static const char SNAPSHOT_MAGIC[8] = {'T', 'X', 'N', 'S', 'N', 'A', 'P', '3'};
+static const uint32_t ENDIAN_CHECK = 0x01020304;
+
+enum ColumnEncoding : uint32_t
+{
+    STRING_HEAP = 1,  // uint64 offsets[rows + 1], then the bytes
+    DICTIONARY = 2,   // uint32 entries, uint32 byte size, uint32 offsets[entries + 1], bytes, uint16 codes[rows]
+    INT64_MICROS = 3, // int64 amounts in millionths[rows]
+    BITSET = 4        // uint64 words[(rows + 63) / 64]
+};
+
+enum SchemaColumn : uint32_t
+{
+    SCHEMA_TRANSACTION_ID,
+    SCHEMA_SENDER_ACCOUNT,
+    SCHEMA_RECEIVER_ACCOUNT,
+    SCHEMA_AMOUNT,
+    SCHEMA_TRANSACTION_TYPE,
+    SCHEMA_LOCATION,
+    SCHEMA_PAYMENT_CHANNEL,
+    SCHEMA_IS_FRAUD,
+    SCHEMA_COLUMN_COUNT
+};
+
+struct ColumnDescriptor
+{
+    uint32_t columnId;
+    uint32_t encoding;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t endianCheck;
+    uint32_t columnCount;
+    int64_t rowCount;
+    int64_t sourceSize;
+    int64_t sourceModifiedTime;
+    int64_t parseErrors;
+    int64_t validationErrors;
+    int64_t malformed;
+    ColumnDescriptor columns[SCHEMA_COLUMN_COUNT];
+};
+
+static uint64_t alignTo8(uint64_t value)
+{
+    return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+static const uint32_t ID_SCHEMA[ColumnarSnapshot::ID_COLUMN_COUNT] = {
+    SCHEMA_TRANSACTION_ID, SCHEMA_SENDER_ACCOUNT, SCHEMA_RECEIVER_ACCOUNT};
+static const uint32_t CATEGORY_SCHEMA[ColumnarSnapshot::CATEGORY_COLUMN_COUNT] = {
+    SCHEMA_TRANSACTION_TYPE, SCHEMA_LOCATION, SCHEMA_PAYMENT_CHANNEL};
+
+// ---------------------------------------------------------------------------------------------
+// Writer
+
+// Growable byte array for the column buffers
+struct ByteBuffer
+{
+    char *data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    ~ByteBuffer() { delete[] data; }
+
+    void append(const void *bytes, size_t length)
+    {
+        if (size + length > capacity)
+        {
+            size_t newCapacity = capacity == 0 ? 4096 : capacity * 2;
+            while (newCapacity < size + length)
+                newCapacity *= 2;
+            char *grown = new char[newCapacity];
+            if (size > 0)
+                memcpy(grown, data, size);
+            delete[] data;
+            data = grown;
+            capacity = newCapacity;
+        }
+        memcpy(data + size, bytes, length);
+        size += length;
+    }
+
+    template <typename T>
+    void appendValue(T value) { append(&value, sizeof(T)); }
+};
+
+// Assigns dense codes to distinct strings (open addressing on an FNV-1a hash)
+struct DictionaryBuilder
+{
+    static const int MAX_ENTRIES = 65535;
+
+    ByteBuffer bytes;
+    ByteBuffer offsets; // uint32 [0, end of entry 0, end of entry 1, ...]
+    int entryCount = 0;
+    int *slots = nullptr;
+    int slotCount = 0;
+
+    DictionaryBuilder() { offsets.appendValue<uint32_t>(0); }
+    ~DictionaryBuilder() { delete[] slots; }
+
+    string_view entry(int index) const
+    {
+        uint32_t start, end;
+        memcpy(&start, offsets.data + index * sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&end, offsets.data + (index + 1) * sizeof(uint32_t), sizeof(uint32_t));
+        return string_view(bytes.data + start, end - start);
+    }
+
+    static uint64_t hash(string_view value)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for (char c : value)
+        {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    void rehash(int newSlotCount)
+    {
+        delete[] slots;
+        slots = new int[newSlotCount];
+        slotCount = newSlotCount;
+        for (int i = 0; i < slotCount; i++)
+            slots[i] = -1;
+        for (int e = 0; e < entryCount; e++)
+        {
+            size_t slot = hash(entry(e)) & (slotCount - 1);
+            while (slots[slot] != -1)
+                slot = (slot + 1) & (slotCount - 1);
+            slots[slot] = e;
+        }
+    }
+
+    // Returns the code of value, adding it when new; -1 once the dictionary is full
+    int lookupOrAdd(string_view value)
+    {
+        if (slotCount == 0)
+            rehash(64);
+
+        size_t slot = hash(value) & (slotCount - 1);
+        while (slots[slot] != -1)
+        {
+            if (entry(slots[slot]) == value)
+                return slots[slot];
+            slot = (slot + 1) & (slotCount - 1);
+        }
+
+        if (entryCount == MAX_ENTRIES)
+            return -1;
+
+        bytes.append(value.data(), value.size());
+        offsets.appendValue<uint32_t>(static_cast<uint32_t>(bytes.size));
+        slots[slot] = entryCount;
+        entryCount++;
+        if (entryCount * 2 > slotCount)
+            rehash(slotCount * 2);
+        return entryCount - 1;
+    }
+};
+
+struct ColumnarSnapshot::Writer::State
+{
+    ByteBuffer idOffsets[ID_COLUMN_COUNT];
+    ByteBuffer idBytes[ID_COLUMN_COUNT];
+    DictionaryBuilder dictionaries[CATEGORY_COLUMN_COUNT];
+    ByteBuffer codes[CATEGORY_COLUMN_COUNT];
+    ByteBuffer amounts;
+    ByteBuffer fraudWords;
+    long long rowCount = 0;
+    string idText; // Reused to decode each packed id
+};
+
+ColumnarSnapshot::Writer::Writer() : state(new State)
+{
+    for (int c = 0; c < ID_COLUMN_COUNT; c++)
+        state->idOffsets[c].appendValue<uint64_t>(0);
+}
+
+ColumnarSnapshot::Writer::~Writer()
+{
+    delete state;
+}
+
+long long ColumnarSnapshot::Writer::getRowCount() const
+{
+    return state->rowCount;
+}
+
+bool ColumnarSnapshot::Writer::addRow(const Transaction &transaction)
+{
+    string_view categories[CATEGORY_COLUMN_COUNT] = {
+        transaction.getTransactionType(), transaction.getLocation(), transaction.getPaymentChannel()};
+    int rowCodes[CATEGORY_COLUMN_COUNT];
+    for (int c = 0; c < CATEGORY_COLUMN_COUNT; c++)
+    {
+        rowCodes[c] = state->dictionaries[c].lookupOrAdd(categories[c]);
+        if (rowCodes[c] < 0)
+            return false;
+    }
+    for (int c = 0; c < CATEGORY_COLUMN_COUNT; c++)
+        state->codes[c].appendValue<uint16_t>(static_cast<uint16_t>(rowCodes[c]));
+
+    CompactId ids[ID_COLUMN_COUNT] = {
+        transaction.getTransactionIDKey(), transaction.getSenderAccountKey(), transaction.getReceiverAccountKey()};
+    for (int c = 0; c < ID_COLUMN_COUNT; c++)
+    {
+        state->idText.clear();
+        ids[c].appendTo(state->idText);
+        state->idBytes[c].append(state->idText.data(), state->idText.size());
+        state->idOffsets[c].appendValue<uint64_t>(state->idBytes[c].size);
+    }
+
+    state->amounts.appendValue<int64_t>(transaction.getAmountMicros());
+
+    long long row = state->rowCount;
+    if (row % 64 == 0)
+        state->fraudWords.appendValue<uint64_t>(0);
+    if (transaction.getIsFraud())
+    {
+        uint64_t word;
+        char *wordAddress = state->fraudWords.data + (row / 64) * sizeof(uint64_t);
+        memcpy(&word, wordAddress, sizeof(word));
+        word |= static_cast<uint64_t>(1) << (row % 64);
+        memcpy(wordAddress, &word, sizeof(word));
+    }
+
+    state->rowCount++;
+    return true;
+}
+
+// Writes to a temporary file first so a crash never leaves a half-written snapshot behind
+bool ColumnarSnapshot::Writer::write(const string &path, long long sourceSize, long long sourceModifiedTime,
+                                     const SourceStats &stats) const
+{
+    long long rows = state->rowCount;
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.endianCheck = ENDIAN_CHECK;
+    header.columnCount = SCHEMA_COLUMN_COUNT;
+    header.rowCount = rows;
+    header.sourceSize = sourceSize;
+    header.sourceModifiedTime = sourceModifiedTime;
+    header.parseErrors = stats.parseErrors;
+    header.validationErrors = stats.validationErrors;
+    header.malformed = stats.malformed;
+
+    // Lay out the sections
+    uint64_t cursor = alignTo8(sizeof(SnapshotHeader));
+    uint64_t dictionaryHeadSizes[CATEGORY_COLUMN_COUNT];
+    for (uint32_t column = 0; column < SCHEMA_COLUMN_COUNT; column++)
+    {
+        ColumnDescriptor &descriptor = header.columns[column];
+        descriptor.columnId = column;
+        descriptor.offset = cursor;
+        switch (column)
+        {
+        case SCHEMA_TRANSACTION_ID:
+        case SCHEMA_SENDER_ACCOUNT:
+        case SCHEMA_RECEIVER_ACCOUNT:
+        {
+            int c = column - SCHEMA_TRANSACTION_ID;
+            descriptor.encoding = STRING_HEAP;
+            descriptor.size = state->idOffsets[c].size + state->idBytes[c].size;
+            break;
+        }
+        case SCHEMA_TRANSACTION_TYPE:
+        case SCHEMA_LOCATION:
+        case SCHEMA_PAYMENT_CHANNEL:
+        {
+            int c = column - SCHEMA_TRANSACTION_TYPE;
+            descriptor.encoding = DICTIONARY;
+            dictionaryHeadSizes[c] = alignTo8(2 * sizeof(uint32_t) + state->dictionaries[c].offsets.size +
+                                              state->dictionaries[c].bytes.size);
+            descriptor.size = dictionaryHeadSizes[c] + state->codes[c].size;
+            break;
+        }
+        case SCHEMA_AMOUNT:
+            descriptor.encoding = INT64_MICROS;
+            descriptor.size = state->amounts.size;
+            break;
+        case SCHEMA_IS_FRAUD:
+            descriptor.encoding = BITSET;
+            descriptor.size = state->fraudWords.size;
+            break;
+        }
+        cursor = alignTo8(cursor + descriptor.size);
+    }
+
+    string temporaryPath = path + ".tmp";
+    ofstream out(temporaryPath, ios::binary | ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    const char padding[8] = {};
+    uint64_t written = 0;
+    auto writeBytes = [&](const void *bytes, size_t length) {
+        out.write(static_cast<const char *>(bytes), length);
+        written += length;
+    };
+    auto padTo = [&](uint64_t offset) {
+        out.write(padding, offset - written);
+        written = offset;
+    };
+
+    writeBytes(&header, sizeof(header));
+    for (uint32_t column = 0; column < SCHEMA_COLUMN_COUNT; column++)
+    {
+        padTo(header.columns[column].offset);
+        switch (column)
+        {
+        case SCHEMA_TRANSACTION_ID:
+        case SCHEMA_SENDER_ACCOUNT:
+        case SCHEMA_RECEIVER_ACCOUNT:
+        {
+            int c = column - SCHEMA_TRANSACTION_ID;
+            writeBytes(state->idOffsets[c].data, state->idOffsets[c].size);
+            writeBytes(state->idBytes[c].data, state->idBytes[c].size);
+            break;
+        }
+        case SCHEMA_TRANSACTION_TYPE:
+        case SCHEMA_LOCATION:
+        case SCHEMA_PAYMENT_CHANNEL:
+        {
+            int c = column - SCHEMA_TRANSACTION_TYPE;
+            const DictionaryBuilder &dictionary = state->dictionaries[c];
+            uint32_t entryCount = static_cast<uint32_t>(dictionary.entryCount);
+            uint32_t byteSize = static_cast<uint32_t>(dictionary.bytes.size);
+            writeBytes(&entryCount, sizeof(entryCount));
+            writeBytes(&byteSize, sizeof(byteSize));
+            writeBytes(dictionary.offsets.data, dictionary.offsets.size);
+            writeBytes(dictionary.bytes.data, dictionary.bytes.size);
+            padTo(header.columns[column].offset + dictionaryHeadSizes[c]);
+            writeBytes(state->codes[c].data, state->codes[c].size);
+            break;
+        }
+        case SCHEMA_AMOUNT:
+            writeBytes(state->amounts.data, state->amounts.size);
+            break;
+        case SCHEMA_IS_FRAUD:
+            writeBytes(state->fraudWords.data, state->fraudWords.size);
+            break;
+        }
+    }
+    out.close();
+    if (!out)
+        return false;
+
+    error_code ec;
+    filesystem::rename(temporaryPath, path, ec);
+    return !ec;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Reader
+
+static StringDictionary &sharedDictionary(ColumnarSnapshot::CategoryColumn column)
+{
+    switch (column)
+    {
+    case ColumnarSnapshot::TRANSACTION_TYPE_COLUMN:
+        return StringDictionary::transactionTypes();
+    case ColumnarSnapshot::LOCATION_COLUMN:
+        return StringDictionary::locations();
+    default:
+        return StringDictionary::paymentChannels();
+    }
+}
+
+ColumnarSnapshot::~ColumnarSnapshot()
+{
+    close();
+}
+
+void ColumnarSnapshot::close()
+{
+    for (int c = 0; c < CATEGORY_COLUMN_COUNT; c++)
+    {
+        delete[] dictionaries[c];
+        delete[] globalCodes[c];
+        dictionaries[c] = nullptr;
+        globalCodes[c] = nullptr;
+        dictionarySizes[c] = 0;
+        categoryCodes[c] = nullptr;
+    }
+    for (int c = 0; c < ID_COLUMN_COUNT; c++)
+    {
+        idOffsets[c] = nullptr;
+        idBytes[c] = nullptr;
+    }
+    amountMicros = nullptr;
+    fraudBits = nullptr;
+    rowCount = 0;
+    sourceStats = SourceStats();
+    file.close();
+}
+
+bool ColumnarSnapshot::open(const string &path, long long sourceSize, long long sourceModifiedTime)
+{
+    close();
+    if (!file.open(path) || file.size() < sizeof(SnapshotHeader))
+    {
+        file.close();
+        return false;
+    }
+
+    const char *base = file.data();
+    uint64_t fileSize = file.size();
+    SnapshotHeader header;
+    memcpy(&header, base, sizeof(header));
+
+    bool valid = memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 &&
+                 header.endianCheck == ENDIAN_CHECK && header.columnCount == SCHEMA_COLUMN_COUNT &&
+                 header.rowCount >= 0 && header.sourceSize == sourceSize &&
+                 header.sourceModifiedTime == sourceModifiedTime;
+    uint64_t rows = static_cast<uint64_t>(header.rowCount);
+    for (uint32_t column = 0; valid && column < SCHEMA_COLUMN_COUNT; column++)
+    {
+        const ColumnDescriptor &descriptor = header.columns[column];
+        valid = descriptor.columnId == column && descriptor.offset % 8 == 0 &&
+                descriptor.offset <= fileSize && descriptor.size <= fileSize - descriptor.offset;
+    }
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    // Pointer fixups: every column becomes a typed pointer into the mapping. Every column holds
+    // at least a byte per row, which also keeps the size arithmetic below from overflowing.
+    valid = rows <= fileSize;
+    for (int c = 0; valid && c < ID_COLUMN_COUNT; c++)
+    {
+        const ColumnDescriptor &descriptor = header.columns[ID_SCHEMA[c]];
+        uint64_t offsetsSize = (rows + 1) * sizeof(uint64_t);
+        valid = descriptor.encoding == STRING_HEAP && descriptor.size >= offsetsSize;
+        if (!valid)
+            break;
+        idOffsets[c] = reinterpret_cast<const uint64_t *>(base + descriptor.offset);
+        idBytes[c] = base + descriptor.offset + offsetsSize;
+
+        // getId trusts every offset, so a truncated or corrupted heap is rejected here
+        uint64_t blobSize = descriptor.size - offsetsSize;
+        valid = idOffsets[c][0] <= blobSize;
+        for (uint64_t row = 0; valid && row < rows; row++)
+            valid = idOffsets[c][row] <= idOffsets[c][row + 1] && idOffsets[c][row + 1] <= blobSize;
+    }
+
+    for (int c = 0; valid && c < CATEGORY_COLUMN_COUNT; c++)
+    {
+        const ColumnDescriptor &descriptor = header.columns[CATEGORY_SCHEMA[c]];
+        valid = descriptor.encoding == DICTIONARY && descriptor.size >= 2 * sizeof(uint32_t);
+        if (!valid)
+            break;
+        const char *section = base + descriptor.offset;
+        uint32_t entryCount, byteSize;
+        memcpy(&entryCount, section, sizeof(entryCount));
+        memcpy(&byteSize, section + sizeof(uint32_t), sizeof(byteSize));
+        uint64_t headSize = alignTo8(2 * sizeof(uint32_t) + (static_cast<uint64_t>(entryCount) + 1) * sizeof(uint32_t) + byteSize);
+        valid = headSize + rows * sizeof(uint16_t) <= descriptor.size;
+        if (!valid)
+            break;
+
+        const uint32_t *entryOffsets = reinterpret_cast<const uint32_t *>(section + 2 * sizeof(uint32_t));
+        const char *entryBytes = section + 2 * sizeof(uint32_t) + (entryCount + 1) * sizeof(uint32_t);
+        dictionaries[c] = new string_view[entryCount > 0 ? entryCount : 1];
+        dictionarySizes[c] = entryCount;
+        for (uint32_t e = 0; valid && e < entryCount; e++)
+        {
+            valid = entryOffsets[e] <= entryOffsets[e + 1] && entryOffsets[e + 1] <= byteSize;
+            if (valid)
+                dictionaries[c][e] = string_view(entryBytes + entryOffsets[e], entryOffsets[e + 1] - entryOffsets[e]);
+        }
+
+        // Remap the snapshot's codes onto the shared dictionaries once, so rows need no lookups
+        StringDictionary &shared = sharedDictionary(static_cast<CategoryColumn>(c));
+        globalCodes[c] = new uint16_t[entryCount > 0 ? entryCount : 1];
+        for (uint32_t e = 0; valid && e < entryCount; e++)
+        {
+            uint32_t code = shared.intern(dictionaries[c][e]);
+            valid = code <= UINT16_MAX;
+            if (valid)
+                globalCodes[c][e] = static_cast<uint16_t>(code);
+        }
+
+        categoryCodes[c] = reinterpret_cast<const uint16_t *>(section + headSize);
+        for (uint64_t row = 0; valid && row < rows; row++)
+            valid = categoryCodes[c][row] < entryCount;
+    }
+
+    if (valid)
+    {
+        const ColumnDescriptor &amountColumn = header.columns[SCHEMA_AMOUNT];
+        const ColumnDescriptor &fraudColumn = header.columns[SCHEMA_IS_FRAUD];
+        valid = amountColumn.encoding == INT64_MICROS && amountColumn.size >= rows * sizeof(int64_t) &&
+                fraudColumn.encoding == BITSET && fraudColumn.size >= (rows + 63) / 64 * sizeof(uint64_t);
+        amountMicros = reinterpret_cast<const int64_t *>(base + amountColumn.offset);
+        fraudBits = reinterpret_cast<const uint64_t *>(base + fraudColumn.offset);
+    }
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    rowCount = header.rowCount;
+    sourceStats.parseErrors = header.parseErrors;
+    sourceStats.validationErrors = header.validationErrors;
+    sourceStats.malformed = header.malformed;
+    return true;
+}
+
+string ColumnarSnapshot::pathFor(const string &csvPath)
+{
+    return csvPath + ".colcache";
+}
@@ -0,0 +1,91 @@
+#include "../include/CompactId.hpp"
+#include "../include/StringDictionary.hpp"
+
+static const int PREFIX_SHIFT = 40;
+static const int DIGIT_COUNT_SHIFT = 36;
+static const uint64_t VALUE_MASK = (1ull << 36) - 1;
+static const int MAX_PREFIX_LENGTH = 3;
+static const int MAX_DIGITS = 15;
+
+static bool isLetter(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+bool CompactId::pack(string_view text, uint64_t &packed)
+{
+    size_t prefixLength = 0;
+    while (prefixLength < text.size() && isLetter(text[prefixLength]))
+        prefixLength++;
+
+    size_t digitCount = text.size() - prefixLength;
+    if (prefixLength > MAX_PREFIX_LENGTH || digitCount == 0 || digitCount > MAX_DIGITS)
+        return false;
+
+    uint64_t value = 0;
+    for (size_t i = prefixLength; i < text.size(); i++)
+    {
+        char c = text[i];
+        if (c < '0' || c > '9')
+            return false;
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+        if (value > VALUE_MASK)
+            return false;
+    }
+
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < prefixLength; i++)
+        prefix = (prefix << 7) | static_cast<uint64_t>(text[i]);
+
+    packed = (1ull << 63) | (static_cast<uint64_t>(prefixLength) << 61) | (prefix << PREFIX_SHIFT) |
+             (static_cast<uint64_t>(digitCount) << DIGIT_COUNT_SHIFT) | value;
+    return true;
+}
+
+bool CompactId::assign(string_view text)
+{
+    uint64_t packed;
+    if (pack(text, packed))
+    {
+        bits = packed;
+        return true;
+    }
+
+    uint32_t code = StringDictionary::identifiers().intern(text);
+    if (code == StringDictionary::INVALID_CODE)
+        return false;
+    bits = code;
+    return true;
+}
+
+void CompactId::appendTo(string &out) const
+{
+    if (!isPacked())
+    {
+        out += StringDictionary::identifiers().decode(static_cast<uint32_t>(bits));
+        return;
+    }
+
+    int prefixLength = static_cast<int>((bits >> 61) & 3);
+    uint64_t prefix = (bits >> PREFIX_SHIFT) & ((1ull << 21) - 1);
+    for (int i = prefixLength - 1; i >= 0; i--)
+        out += static_cast<char>((prefix >> (7 * i)) & 0x7F);
+
+    // Digits are produced right to left into a small buffer, zero-padded to the stored width
+    int digitCount = static_cast<int>((bits >> DIGIT_COUNT_SHIFT) & 0xF);
+    uint64_t value = bits & VALUE_MASK;
+    char digits[MAX_DIGITS];
+    for (int i = digitCount - 1; i >= 0; i--)
+    {
+        digits[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(digits, digitCount);
+}
+
+string CompactId::toString() const
+{
+    string text;
+    appendTo(text);
+    return text;
+}
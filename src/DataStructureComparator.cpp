@@ -1,4 +1,6 @@
 #include "../include/DataStructureComparator.hpp"
+#include <algorithm>
+#include <cstring>
 
 DataStructureComparator::DataStructureComparator(Transaction *transactions, int numTransactions, const string &searchKey)
     : transactions(transactions), numTransactions(numTransactions), searchKey(searchKey)
@@ -6,6 +8,7 @@ DataStructureComparator::DataStructureComparator(Transaction *transactions, int
     // Initialize metrics
     arrayMetrics = {};
     linkedListMetrics = {};
+    tableMetrics = {};
 }
 
 DataStructureComparator::~DataStructureComparator()
@@ -16,7 +19,8 @@ DataStructureComparator::~DataStructureComparator()
 void DataStructureComparator::calculateMemoryUsage()
 {
     arrayMetrics.memoryUsage = numTransactions * sizeof(Transaction);
-    linkedListMetrics.memoryUsage = numTransactions * (sizeof(Transaction) + sizeof(void *));
+    // List nodes hold only the hot sort key and read the other fields from the array
+    linkedListMetrics.memoryUsage = numTransactions * (sizeof(HotRecord) + sizeof(void *));
 }
 
 void DataStructureComparator::processArrayStructureSilent()
@@ -35,6 +39,52 @@ void DataStructureComparator::processArrayStructureSilent()
     arrayMetrics.processingTime = arrayCollection.getSearchTime();
 }
 
+void DataStructureComparator::processTableStructureSilent()
+{
+    auto tableStartTime = chrono::high_resolution_clock::now();
+    TransactionTable table;
+    table.appendBatch(transactions, numTransactions);
+    auto tableBuiltTime = chrono::high_resolution_clock::now();
+
+    ArrayBasedCollection arrayCollection(searchKey, numTransactions, transactions);
+    arrayCollection.processTableSilently(table, searchKey);
+
+    auto tableEndTime = chrono::high_resolution_clock::now();
+
+    tableMetrics.creationTime = chrono::duration_cast<chrono::microseconds>(tableBuiltTime - tableStartTime);
+    tableMetrics.totalTime = chrono::duration_cast<chrono::microseconds>(tableEndTime - tableStartTime);
+    tableMetrics.sortingTime = arrayCollection.getSortTime();
+    tableMetrics.processingTime = arrayCollection.getSearchTime();
+    tableMetrics.memoryUsage = table.memoryUsage();
+    tableTotalAmount = table.getTotalAmount();
+    tableProcessed = true;
+}
+
+void DataStructureComparator::processArraySortModeSilent(ArrayBasedCollection::SortMode mode, ArrayBasedCollection::SortEngine engine,
+                                                         const string &name)
+{
+    if (arrayVariantCount == MAX_ARRAY_VARIANTS)
+        return;
+
+    // Some modes reorder their input; the caller's rows must stay as they are
+    Transaction *rows = new Transaction[numTransactions > 0 ? numTransactions : 1];
+    memcpy(static_cast<void *>(rows), transactions, static_cast<size_t>(numTransactions) * sizeof(Transaction));
+
+    auto startTime = chrono::high_resolution_clock::now();
+    ArrayBasedCollection arrayCollection(searchKey, numTransactions, rows);
+    arrayCollection.setSortMode(mode);
+    arrayCollection.setSortEngine(engine);
+    arrayCollection.processSilently(rows, numTransactions, searchKey);
+    auto endTime = chrono::high_resolution_clock::now();
+
+    ArrayVariant &variant = arrayVariants[arrayVariantCount++];
+    variant.name = name;
+    variant.metrics = {};
+    variant.metrics.totalTime = chrono::duration_cast<chrono::microseconds>(endTime - startTime);
+    variant.metrics.sortingTime = arrayCollection.getSortTime();
+    variant.metrics.processingTime = arrayCollection.getSearchTime();
+    delete[] rows;
+}
 
 void DataStructureComparator::processLinkedListStructureSilent()
 {
@@ -53,6 +103,34 @@ void DataStructureComparator::processLinkedListStructureSilent()
     linkedListMetrics.processingTime = linkedListCollection.getSearchTime();
 }
 
+void DataStructureComparator::processLinkedListInBatches(int batchSize)
+{
+    long long totalLinkedListTime = 0;
+    long long totalSearchTime = 0;
+    long long totalSortTime = 0;
+
+    for (int i = 0; i < numTransactions; i += batchSize)
+    {
+        int currentBatchSize = min(batchSize, numTransactions - i);
+        Transaction *batch_ptr = &transactions[i];
+
+        auto llBatchStart = chrono::high_resolution_clock::now();
+
+        LinkedListBasedCollection batchLinkedList(searchKey, currentBatchSize, batch_ptr);
+        batchLinkedList.processSilently(searchKey);
+
+        auto llBatchEnd = chrono::high_resolution_clock::now();
+        totalLinkedListTime += chrono::duration_cast<chrono::microseconds>(llBatchEnd - llBatchStart).count();
+
+        totalSearchTime += batchLinkedList.getSearchTime().count();
+        totalSortTime += batchLinkedList.getSortTime().count();
+    }
+
+    setLinkedListTime(totalLinkedListTime);
+    setLinkedListSearchTime(totalSearchTime);
+    setLinkedListSortTime(totalSortTime);
+}
+
 void DataStructureComparator::displayFinalSummary()
 {
     calculateMemoryUsage();
@@ -63,7 +141,11 @@ void DataStructureComparator::displayFinalSummary()
 
     cout << "Data Structures Used:" << endl;
     cout << "  Array" << endl;
+    for (int v = 0; v < arrayVariantCount; v++)
+        cout << "  Array (" << arrayVariants[v].name << ")" << endl;
     cout << "  LinkedList" << endl;
+    if (tableProcessed)
+        cout << "  Column Table (struct of arrays)" << endl;
     cout << "\n========================================" << endl;
     cout << "DATA STRUCTURE COMPARISON:" << endl;
 
@@ -82,7 +164,11 @@ void DataStructureComparator::displayFinalSummary()
     cout << "Search Time:" << endl;
 
     cout << "  Array: " << arrayMetrics.processingTime.count() << " μs" << endl;
+    for (int v = 0; v < arrayVariantCount; v++)
+        cout << "  Array (" << arrayVariants[v].name << "): " << arrayVariants[v].metrics.processingTime.count() << " μs" << endl;
     cout << "  LinkedList: " << linkedListMetrics.processingTime.count() << " μs" << endl;
+    if (tableProcessed)
+        cout << "  Column Table: " << tableMetrics.processingTime.count() << " μs" << endl;
     if (arrayMetrics.processingTime.count() > 0 && linkedListMetrics.processingTime.count() > 0)
     {
         if (arrayMetrics.processingTime < linkedListMetrics.processingTime)
@@ -100,7 +186,11 @@ void DataStructureComparator::displayFinalSummary()
     cout << "\nSort Time:" << endl;
 
     cout << "  Array: " << arrayMetrics.sortingTime.count() << " μs" << endl;
+    for (int v = 0; v < arrayVariantCount; v++)
+        cout << "  Array (" << arrayVariants[v].name << "): " << arrayVariants[v].metrics.sortingTime.count() << " μs" << endl;
     cout << "  LinkedList: " << linkedListMetrics.sortingTime.count() << " μs" << endl;
+    if (tableProcessed)
+        cout << "  Column Table: " << tableMetrics.sortingTime.count() << " μs" << endl;
     if (arrayMetrics.sortingTime.count() > 0 && linkedListMetrics.sortingTime.count() > 0)
     {
         if (arrayMetrics.sortingTime < linkedListMetrics.sortingTime)
@@ -129,7 +219,7 @@ void DataStructureComparator::displayFinalSummary()
 
     cout << "\nSort Algorithm Memory Usage:" << endl;
 
-    size_t arraySortMemory = numTransactions * sizeof(Transaction) * 2;                         // Merge sort needs temporary arrays
+    size_t arraySortMemory = numTransactions * (sizeof(Transaction) + 2 * sizeof(HotRecord));    // Rows plus one shared key buffer and its scratch
     size_t linkedListSortMemory = numTransactions * (sizeof(Transaction) + sizeof(void *) * 2); // LinkedList sort needs extra pointers
     cout << "  Array Sort: " << (arraySortMemory / 1024.0 / 1024.0) << " MB (temporary arrays)" << endl;
     cout << "  LinkedList Sort: " << (linkedListSortMemory / 1024.0 / 1024.0) << " MB (pointer manipulation)" << endl;
@@ -152,12 +242,20 @@ void DataStructureComparator::displayFinalSummary()
     } else {
         cout << "Array: " << (arrayMetrics.totalTime.count() / 1000.0) << " ms" << endl;
     }
+    for (int v = 0; v < arrayVariantCount; v++)
+        cout << "Array (" << arrayVariants[v].name << "): " << (arrayVariants[v].metrics.totalTime.count() / 1000.0) << " ms" << endl;
     
     if (linkedListMetrics.totalTime.count() < 1000) {
         cout << "LinkedList: " << linkedListMetrics.totalTime.count() << " μs" << endl;
     } else {
         cout << "LinkedList: " << (linkedListMetrics.totalTime.count() / 1000.0) << " ms" << endl;
     }
+    if (tableProcessed)
+    {
+        cout << "Column Table: " << (tableMetrics.totalTime.count() / 1000.0) << " ms (build "
+             << (tableMetrics.creationTime.count() / 1000.0) << " ms)" << endl;
+        cout << "Column Table amount total: " << tableTotalAmount.toString() << " (exact)" << endl;
+    }
 
     if (arrayMetrics.totalTime.count() > 0 && linkedListMetrics.totalTime.count() > 0)
     {
@@ -177,6 +275,8 @@ void DataStructureComparator::displayFinalSummary()
 
     cout << "Array: " << (arrayMetrics.memoryUsage / 1024.0 / 1024.0) << " MB" << endl;
     cout << "LinkedList: " << (linkedListMetrics.memoryUsage / 1024.0 / 1024.0) << " MB" << endl;
+    if (tableProcessed)
+        cout << "Column Table: " << (tableMetrics.memoryUsage / 1024.0 / 1024.0) << " MB" << endl;
     double memoryOverhead = (100.0 * linkedListMetrics.memoryUsage / arrayMetrics.memoryUsage) - 100.0;
     cout << "Difference: LinkedList uses " << memoryOverhead << "% more memory" << endl;
     cout << "========================================" << endl;
@@ -6,7 +6,7 @@
 using namespace std;
 
 LinkedListBasedCollection::LinkedListBasedCollection(string &searchKey, int numTransactions, Transaction *transactions)
-    : searchKey(searchKey), numTransactions(numTransactions), head(nullptr),
+    : head(nullptr), transactions(transactions), searchKey(searchKey), numTransactions(numTransactions),
       searchTime(chrono::microseconds::zero()), sortTime(chrono::microseconds::zero())
 {
     // Convert array to linked list
@@ -23,14 +23,14 @@ void LinkedListBasedCollection::convertArrayToLinkedList(Transaction *transactio
 {
     for (int i = 0; i < numTransactions; i++)
     {
-        insertTransaction(transactions[i]);
+        insertTransaction(transactions[i], static_cast<uint32_t>(i));
     }
 }
 
-void LinkedListBasedCollection::insertTransaction(const Transaction &transaction)
+void LinkedListBasedCollection::insertTransaction(const Transaction &transaction, uint32_t row)
 {
     TransactionNode *newNode = new TransactionNode;
-    newNode->transaction = transaction;
+    newNode->record = HotRecord::fromTransaction(transaction, row);
     newNode->next = head;
     head = newNode;
 }
@@ -63,12 +63,12 @@ void LinkedListBasedCollection::processSilently(string &searchKey)
 
     while (current != nullptr)
     {
-        string currentChannel = current->transaction.getPaymentChannel();
+        uint16_t currentChannelRank = current->record.paymentChannelRank;
 
         // Count transactions in this channel and "search" through them
         TransactionNode *temp = current;
         int channelSize = 0;
-        while (temp != nullptr && temp->transaction.getPaymentChannel() == currentChannel)
+        while (temp != nullptr && temp->record.paymentChannelRank == currentChannelRank)
         {
             channelSize++;
             totalTransactionsProcessed++;
@@ -98,12 +98,12 @@ void LinkedListBasedCollection::processSilently(string &searchKey)
     current = head;
     while (current != nullptr)
     {
-        string currentChannel = current->transaction.getPaymentChannel();
+        uint16_t currentChannelRank = current->record.paymentChannelRank;
 
         // Find the end of this channel group
         TransactionNode *channelEnd = current;
         while (channelEnd->next != nullptr &&
-               channelEnd->next->transaction.getPaymentChannel() == currentChannel)
+               channelEnd->next->record.paymentChannelRank == currentChannelRank)
         {
             channelEnd = channelEnd->next;
         }
@@ -129,7 +129,7 @@ void LinkedListBasedCollection::processSilently(string &searchKey)
 
         // Move to next channel
         current = current->next;
-        while (current != nullptr && current->transaction.getPaymentChannel() == currentChannel)
+        while (current != nullptr && current->record.paymentChannelRank == currentChannelRank)
         {
             current = current->next;
         }
@@ -143,14 +143,17 @@ int LinkedListBasedCollection::searchByTransactionTypeInChannel(TransactionNode
 {
     int groupSize = 0;
     TransactionNode *current = channelStart;
+    // Unknown names get INVALID_CODE, which no row carries
+    uint32_t channelCode = StringDictionary::paymentChannels().find(channelName);
+    uint32_t searchCode = StringDictionary::transactionTypes().find(searchKey);
 
-    while (current != nullptr && current->transaction.getPaymentChannel() == channelName)
+    while (current != nullptr && transactions[current->record.row].getPaymentChannelCode() == channelCode)
     {
-        if (current->transaction.getTransactionType() == searchKey)
+        if (transactions[current->record.row].getTransactionTypeCode() == searchCode)
         {
             // Add to group linked list
             TransactionNode *newNode = new TransactionNode;
-            newNode->transaction = current->transaction;
+            newNode->record = current->record;
             newNode->next = groupHead;
             groupHead = newNode;
             groupSize++;
@@ -217,7 +220,8 @@ LinkedListBasedCollection::TransactionNode *LinkedListBasedCollection::mergeByPa
 
     TransactionNode *result = nullptr;
 
-    if (left->transaction.getPaymentChannel() <= right->transaction.getPaymentChannel())
+    // Ranks order the channel codes alphabetically
+    if (left->record.paymentChannelRank <= right->record.paymentChannelRank)
     {
         result = left;
         result->next = mergeByPaymentChannel(left->next, right);
@@ -259,12 +263,12 @@ LinkedListBasedCollection::TransactionNode *LinkedListBasedCollection::mergeByAm
     TransactionNode *result = nullptr;
 
     // Primary sort: by amount (descending - highest first)
-    if (left->transaction.getAmount() > right->transaction.getAmount())
+    if (left->record.amountMicros > right->record.amountMicros)
     {
         result = left;
         result->next = mergeByAmountThenLocation(left->next, right);
     }
-    else if (left->transaction.getAmount() < right->transaction.getAmount())
+    else if (left->record.amountMicros < right->record.amountMicros)
     {
         result = right;
         result->next = mergeByAmountThenLocation(left, right->next);
@@ -272,7 +276,7 @@ LinkedListBasedCollection::TransactionNode *LinkedListBasedCollection::mergeByAm
     else
     {
         // Secondary sort: by location (ascending - alphabetical)
-        if (left->transaction.getLocation() <= right->transaction.getLocation())
+        if (left->record.locationRank <= right->record.locationRank)
         {
             result = left;
             result->next = mergeByAmountThenLocation(left->next, right);
@@ -0,0 +1,176 @@
+#include "../include/StringDictionary.hpp"
+
+StringDictionary::StringDictionary(uint32_t maxEntries, bool ordered)
+    : maxEntries(maxEntries), ordered(ordered), entryCount(0), table(nullptr)
+{
+    uint32_t blockCount = (maxEntries + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    blocks = new string_view *[blockCount]();
+
+    SlotTable *initial = new SlotTable;
+    initial->mask = 63;
+    initial->slots = new atomic<uint32_t>[initial->mask + 1];
+    for (uint32_t i = 0; i <= initial->mask; i++)
+        initial->slots[i].store(0, memory_order_relaxed);
+    initial->previous = nullptr;
+    table.store(initial, memory_order_release);
+
+    if (ordered)
+    {
+        sortedCodes = new uint32_t[maxEntries];
+        ranks = new uint32_t[maxEntries];
+    }
+
+    intern(""); // Reserve EMPTY_CODE so default-constructed rows decode to ""
+}
+
+StringDictionary::~StringDictionary()
+{
+    SlotTable *current = table.load(memory_order_relaxed);
+    while (current != nullptr)
+    {
+        SlotTable *previous = current->previous;
+        delete[] current->slots;
+        delete current;
+        current = previous;
+    }
+
+    uint32_t blockCount = (maxEntries + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    for (uint32_t i = 0; i < blockCount; i++)
+        delete[] blocks[i];
+    delete[] blocks;
+    delete[] sortedCodes;
+    delete[] ranks;
+}
+
+// FNV-1a
+uint64_t StringDictionary::hash(string_view value)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (char c : value)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint32_t StringDictionary::find(string_view value) const
+{
+    SlotTable *current = table.load(memory_order_acquire);
+    for (uint32_t slot = static_cast<uint32_t>(hash(value)) & current->mask;; slot = (slot + 1) & current->mask)
+    {
+        uint32_t stored = current->slots[slot].load(memory_order_acquire);
+        if (stored == 0)
+            return INVALID_CODE;
+        if (decode(stored - 1) == value)
+            return stored - 1;
+    }
+}
+
+uint32_t StringDictionary::intern(string_view value)
+{
+    uint32_t code = find(value);
+    if (code != INVALID_CODE)
+        return code;
+
+    lock_guard<mutex> guard(writeLock);
+
+    // Another thread may have added it while we were waiting
+    code = find(value);
+    if (code != INVALID_CODE)
+        return code;
+
+    code = entryCount.load(memory_order_relaxed);
+    if (code >= maxEntries)
+        return INVALID_CODE;
+
+    if (blocks[code / BLOCK_SIZE] == nullptr)
+        blocks[code / BLOCK_SIZE] = new string_view[BLOCK_SIZE];
+    blocks[code / BLOCK_SIZE][code % BLOCK_SIZE] = arena.copy(value);
+
+    SlotTable *current = table.load(memory_order_relaxed);
+    if ((code + 1) * 2 > current->mask + 1)
+        current = grow(current);
+
+    if (ordered)
+        insertRank(code);
+
+    // Publishing the slot last makes the entry (and its rank) visible to lock-free readers
+    insertSlot(current, hash(value), code);
+    entryCount.store(code + 1, memory_order_release);
+    return code;
+}
+
+void StringDictionary::insertSlot(SlotTable *slotTable, uint64_t valueHash, uint32_t code)
+{
+    uint32_t slot = static_cast<uint32_t>(valueHash) & slotTable->mask;
+    while (slotTable->slots[slot].load(memory_order_relaxed) != 0)
+        slot = (slot + 1) & slotTable->mask;
+    slotTable->slots[slot].store(code + 1, memory_order_release);
+}
+
+StringDictionary::SlotTable *StringDictionary::grow(SlotTable *current)
+{
+    SlotTable *grown = new SlotTable;
+    grown->mask = current->mask * 2 + 1;
+    grown->slots = new atomic<uint32_t>[grown->mask + 1];
+    for (uint32_t i = 0; i <= grown->mask; i++)
+        grown->slots[i].store(0, memory_order_relaxed);
+    grown->previous = current;
+
+    uint32_t count = entryCount.load(memory_order_relaxed);
+    for (uint32_t code = 0; code < count; code++)
+        insertSlot(grown, hash(decode(code)), code);
+
+    table.store(grown, memory_order_release);
+    return grown;
+}
+
+// Keeps sortedCodes alphabetical and ranks in step (few distinct values, so linear is fine)
+void StringDictionary::insertRank(uint32_t code)
+{
+    uint32_t count = entryCount.load(memory_order_relaxed);
+    string_view value = decode(code);
+
+    uint32_t low = 0, high = count;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (decode(sortedCodes[mid]) < value)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    for (uint32_t i = count; i > low; i--)
+    {
+        sortedCodes[i] = sortedCodes[i - 1];
+        ranks[sortedCodes[i]] = i;
+    }
+    sortedCodes[low] = code;
+    ranks[code] = low;
+}
+
+StringDictionary &StringDictionary::transactionTypes()
+{
+    static StringDictionary dictionary(65535, true);
+    return dictionary;
+}
+
+StringDictionary &StringDictionary::locations()
+{
+    static StringDictionary dictionary(65535, true);
+    return dictionary;
+}
+
+StringDictionary &StringDictionary::paymentChannels()
+{
+    static StringDictionary dictionary(65535, true);
+    return dictionary;
+}
+
+StringDictionary &StringDictionary::identifiers()
+{
+    static StringDictionary dictionary(1u << 24, false);
+    return dictionary;
+}
@@ -0,0 +1,154 @@
+#include "../include/TopKByChannel.hpp"
+
+TopKByChannel::TopKByChannel(int k) : k(k > 0 ? k : 0)
+{
+}
+
+TopKByChannel::~TopKByChannel()
+{
+    clear();
+}
+
+void TopKByChannel::clear()
+{
+    for (int c = 0; c < channelCount; c++)
+        delete[] channels[c].heap;
+    delete[] channels;
+    channels = nullptr;
+    channelCount = 0;
+    channelCapacity = 0;
+    lastChannel = -1;
+    offered = 0;
+}
+
+// Amount descending, then location ascending, then whichever arrived first
+bool TopKByChannel::sortsBefore(const Entry &a, const Entry &b)
+{
+    if (a.row.getAmountMicros() != b.row.getAmountMicros())
+        return a.row.getAmountMicros() > b.row.getAmountMicros();
+    // Live ranks: interning new locations shifts them but never reorders existing ones
+    uint32_t aLocation = a.row.getLocationRank();
+    uint32_t bLocation = b.row.getLocationRank();
+    if (aLocation != bLocation)
+        return aLocation < bLocation;
+    return a.sequence < b.sequence;
+}
+
+void TopKByChannel::siftDown(Entry heap[], int size, int index)
+{
+    while (true)
+    {
+        int last = index;
+        int left = 2 * index + 1;
+        int right = left + 1;
+        if (left < size && sortsBefore(heap[last], heap[left]))
+            last = left;
+        if (right < size && sortsBefore(heap[last], heap[right]))
+            last = right;
+        if (last == index)
+            return;
+        Entry swap = heap[index];
+        heap[index] = heap[last];
+        heap[last] = swap;
+        index = last;
+    }
+}
+
+TopKByChannel::Channel &TopKByChannel::channelFor(uint16_t code)
+{
+    if (lastChannel >= 0 && channels[lastChannel].code == code)
+        return channels[lastChannel];
+    for (int c = 0; c < channelCount; c++)
+    {
+        if (channels[c].code == code)
+        {
+            lastChannel = c;
+            return channels[c];
+        }
+    }
+
+    if (channelCount == channelCapacity)
+    {
+        int newCapacity = channelCapacity == 0 ? 8 : channelCapacity * 2;
+        Channel *grown = new Channel[newCapacity];
+        for (int c = 0; c < channelCount; c++)
+            grown[c] = channels[c];
+        delete[] channels;
+        channels = grown;
+        channelCapacity = newCapacity;
+    }
+    Channel &added = channels[channelCount];
+    added.code = code;
+    added.heap = new Entry[k > 0 ? k : 1];
+    added.size = 0;
+    lastChannel = channelCount++;
+    return added;
+}
+
+void TopKByChannel::append(const Transaction &transaction)
+{
+    Entry entry;
+    entry.row = transaction;
+    entry.sequence = offered++;
+    if (k == 0)
+        return;
+
+    Channel &channel = channelFor(transaction.getPaymentChannelCode());
+    if (channel.size < k)
+    {
+        // Sift up
+        int index = channel.size++;
+        while (index > 0)
+        {
+            int parent = (index - 1) / 2;
+            if (!sortsBefore(channel.heap[parent], entry))
+                break;
+            channel.heap[index] = channel.heap[parent];
+            index = parent;
+        }
+        channel.heap[index] = entry;
+    }
+    else if (sortsBefore(entry, channel.heap[0]))
+    {
+        // Displaces the current last row
+        channel.heap[0] = entry;
+        siftDown(channel.heap, channel.size, 0);
+    }
+}
+
+void TopKByChannel::appendBatch(const Transaction batch[], int batchSize)
+{
+    for (int i = 0; i < batchSize; i++)
+        append(batch[i]);
+}
+
+void TopKByChannel::finish()
+{
+    // Heap sort: repeatedly move the row that sorts last to the end
+    for (int c = 0; c < channelCount; c++)
+    {
+        Entry *heap = channels[c].heap;
+        for (int end = channels[c].size - 1; end > 0; end--)
+        {
+            Entry swap = heap[0];
+            heap[0] = heap[end];
+            heap[end] = swap;
+            siftDown(heap, end, 0);
+        }
+    }
+
+    // A handful of channels: insertion sort by rank
+    const StringDictionary &names = StringDictionary::paymentChannels();
+    for (int i = 1; i < channelCount; i++)
+    {
+        Channel moving = channels[i];
+        int j = i - 1;
+        while (j >= 0 && names.rank(channels[j].code) > names.rank(moving.code))
+        {
+            channels[j + 1] = channels[j];
+            j--;
+        }
+        channels[j + 1] = moving;
+    }
+    lastChannel = -1;
+}
@@ -3,24 +3,91 @@
 using namespace std;
 #include "../include/Transaction.hpp"
 
-Transaction::Transaction(const string &transactionID,
-                        const string &senderAccount,
-                        const string &receiverAccount,
-                        double amount,
-                        const string &transactionType,
-                        const string &location,
-                        const string &paymentChannel,
-                        bool isFraud)
-    : transactionID(transactionID),
-      senderAccount(senderAccount),
-      receiverAccount(receiverAccount),
-      amount(amount),
-      transactionType(transactionType),
-      location(location),
-      paymentChannel(paymentChannel),
+Transaction::Transaction(string_view transactionID,
+                         string_view senderAccount,
+                         string_view receiverAccount,
+                         double amount,
+                         string_view transactionType,
+                         string_view location,
+                         string_view paymentChannel,
+                         bool isFraud)
+    : amount(Amount::fromDouble(amount)),
       isFraud(isFraud)
 {
-    // Constructor body (if needed)
+    // A value that cannot be interned (dictionary full) is left as the empty string
+    this->transactionID.assign(transactionID);
+    this->senderAccount.assign(senderAccount);
+    this->receiverAccount.assign(receiverAccount);
+    uint32_t code = StringDictionary::transactionTypes().intern(transactionType);
+    if (code <= UINT16_MAX)
+        transactionTypeCode = static_cast<uint16_t>(code);
+    code = StringDictionary::locations().intern(location);
+    if (code <= UINT16_MAX)
+        locationCode = static_cast<uint16_t>(code);
+    code = StringDictionary::paymentChannels().intern(paymentChannel);
+    if (code <= UINT16_MAX)
+        paymentChannelCode = static_cast<uint16_t>(code);
+}
+
+bool Transaction::assign(string_view transactionID,
+                         string_view senderAccount,
+                         string_view receiverAccount,
+                         Amount amount,
+                         string_view transactionType,
+                         string_view location,
+                         string_view paymentChannel,
+                         bool isFraud)
+{
+    uint32_t typeCode = StringDictionary::transactionTypes().intern(transactionType);
+    uint32_t locationCode = StringDictionary::locations().intern(location);
+    uint32_t channelCode = StringDictionary::paymentChannels().intern(paymentChannel);
+    if (typeCode > UINT16_MAX || locationCode > UINT16_MAX || channelCode > UINT16_MAX)
+        return false;
+
+    return assignEncoded(transactionID, senderAccount, receiverAccount, amount,
+                         static_cast<uint16_t>(typeCode), static_cast<uint16_t>(locationCode),
+                         static_cast<uint16_t>(channelCode), isFraud);
+}
+
+bool Transaction::assignEncoded(string_view transactionID,
+                                string_view senderAccount,
+                                string_view receiverAccount,
+                                Amount amount,
+                                uint16_t transactionTypeCode,
+                                uint16_t locationCode,
+                                uint16_t paymentChannelCode,
+                                bool isFraud)
+{
+    if (!this->transactionID.assign(transactionID) ||
+        !this->senderAccount.assign(senderAccount) ||
+        !this->receiverAccount.assign(receiverAccount))
+        return false;
+
+    this->amount = amount;
+    this->transactionTypeCode = transactionTypeCode;
+    this->locationCode = locationCode;
+    this->paymentChannelCode = paymentChannelCode;
+    this->isFraud = isFraud;
+    return true;
+}
+
+void Transaction::assignEncoded(CompactId transactionID,
+                                CompactId senderAccount,
+                                CompactId receiverAccount,
+                                Amount amount,
+                                uint16_t transactionTypeCode,
+                                uint16_t locationCode,
+                                uint16_t paymentChannelCode,
+                                bool isFraud)
+{
+    this->transactionID = transactionID;
+    this->senderAccount = senderAccount;
+    this->receiverAccount = receiverAccount;
+    this->amount = amount;
+    this->transactionTypeCode = transactionTypeCode;
+    this->locationCode = locationCode;
+    this->paymentChannelCode = paymentChannelCode;
+    this->isFraud = isFraud;
 }
 
 // Getter implementations
@@ -28,42 +95,42 @@ Transaction::Transaction(const string &transactionID,
 
 nlohmann::json Transaction::to_json() const {
     nlohmann::json j;
-    j["transactionID"] = transactionID;
-    j["senderAccount"] = senderAccount;
-    j["receiverAccount"] = receiverAccount;
-    j["amount"] = amount;
-    j["transactionType"] = transactionType;
-    j["location"] = location;
-    j["paymentChannel"] = paymentChannel;
+    j["transactionID"] = transactionID.toString();
+    j["senderAccount"] = senderAccount.toString();
+    j["receiverAccount"] = receiverAccount.toString();
+    j["amount"] = amount.toDouble();
+    j["transactionType"] = StringDictionary::transactionTypes().decode(transactionTypeCode);
+    j["location"] = StringDictionary::locations().decode(locationCode);
+    j["paymentChannel"] = StringDictionary::paymentChannels().decode(paymentChannelCode);
     j["isFraud"] = isFraud;
     return j;
 }
 string Transaction::getTransactionID() const {
-    return transactionID;
+    return transactionID.toString();
 }
 
 string Transaction::getSenderAccount() const {
-    return senderAccount;
+    return senderAccount.toString();
 }
 
 string Transaction::getReceiverAccount() const {
-    return receiverAccount;
+    return receiverAccount.toString();
 }
 
 double Transaction::getAmount() const {
-    return amount;
+    return amount.toDouble();
 }
 
-string Transaction::getTransactionType() const {
-    return transactionType;
+string_view Transaction::getTransactionType() const {
+    return StringDictionary::transactionTypes().decode(transactionTypeCode);
 }
 
-string Transaction::getLocation() const {
-    return location;
+string_view Transaction::getLocation() const {
+    return StringDictionary::locations().decode(locationCode);
 }
 
-string Transaction::getPaymentChannel() const {
-    return paymentChannel;
+string_view Transaction::getPaymentChannel() const {
+    return StringDictionary::paymentChannels().decode(paymentChannelCode);
 }
 
 bool Transaction::getIsFraud() const {
@@ -96,14 +163,13 @@ void Transaction::showUniqueTransactionTypes(Transaction* transactions, int coun
         return;
     }
 
-    // Use a simple array to store unique types (max 50 types should be enough)
-    string uniqueTypes[50];
+    // Use a simple array to store unique type codes (max 50 types should be enough)
+    uint16_t uniqueTypes[50];
     int uniqueCount = 0;
 
-    // This part of the logic does not need to change.
-    // It correctly finds all unique internal types.
+    // Compare dictionary codes; names are only decoded for printing
     for (int i = 0; i < count; i++) {
-        string type = transactions[i].getTransactionType();
+        uint16_t type = transactions[i].getTransactionTypeCode();
         
         // Check if this type is already in our unique types array
         bool found = false;
@@ -126,7 +192,7 @@ void Transaction::showUniqueTransactionTypes(Transaction* transactions, int coun
     // *** MODIFICATION IS HERE ***
     // Use the helper function to print the formatted names.
     for (int i = 0; i < uniqueCount; i++) {
-        cout << (i + 1) << ". " << formatTransactionTypeForDisplay(uniqueTypes[i]) << endl;
+        cout << (i + 1) << ". " << formatTransactionTypeForDisplay(string(StringDictionary::transactionTypes().decode(uniqueTypes[i]))) << endl;
 }
 
 
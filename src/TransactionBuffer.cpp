@@ -0,0 +1,73 @@
+#include "../include/TransactionBuffer.hpp"
+
+TransactionBuffer::~TransactionBuffer()
+{
+    clear();
+}
+
+void TransactionBuffer::addChunk()
+{
+    // Only the chunk pointer table is reallocated, never the rows themselves
+    if (chunkCount == chunkCapacity)
+    {
+        int newCapacity = chunkCapacity == 0 ? 16 : chunkCapacity * 2;
+        Transaction **grown = new Transaction *[newCapacity];
+        for (int i = 0; i < chunkCount; i++)
+            grown[i] = chunks[i];
+        delete[] chunks;
+        chunks = grown;
+        chunkCapacity = newCapacity;
+    }
+    chunks[chunkCount++] = new Transaction[CHUNK_SIZE];
+}
+
+void TransactionBuffer::append(Transaction &&transaction)
+{
+    if (count == static_cast<long long>(chunkCount) * CHUNK_SIZE)
+        addChunk();
+    chunks[count / CHUNK_SIZE][count % CHUNK_SIZE] = std::move(transaction);
+    count++;
+}
+
+void TransactionBuffer::append(const Transaction &transaction)
+{
+    // Rows are trivially copyable, so this is the same single store as the move overload
+    if (count == static_cast<long long>(chunkCount) * CHUNK_SIZE)
+        addChunk();
+    chunks[count / CHUNK_SIZE][count % CHUNK_SIZE] = transaction;
+    count++;
+}
+
+void TransactionBuffer::appendBatch(Transaction batch[], int batchSize)
+{
+    for (int i = 0; i < batchSize; i++)
+        append(std::move(batch[i]));
+}
+
+void TransactionBuffer::clear()
+{
+    for (int i = 0; i < chunkCount; i++)
+        delete[] chunks[i];
+    delete[] chunks;
+    chunks = nullptr;
+    chunkCount = 0;
+    chunkCapacity = 0;
+    count = 0;
+}
+
+Transaction *TransactionBuffer::moveToArray()
+{
+    Transaction *result = new Transaction[count > 0 ? count : 1];
+    long long next = 0;
+    for (int c = 0; c < chunkCount; c++)
+    {
+        // Release each chunk as soon as it is drained to keep the peak footprint down
+        for (int i = 0; i < CHUNK_SIZE && next < count; i++)
+            result[next++] = std::move(chunks[c][i]);
+        delete[] chunks[c];
+        chunks[c] = nullptr;
+    }
+    chunkCount = 0;
+    clear();
+    return result;
+}
@@ -0,0 +1,100 @@
+#include "../include/TransactionTable.hpp"
+#include <cstring>
+
+TransactionTable::~TransactionTable()
+{
+    clear();
+}
+
+void TransactionTable::clear()
+{
+    delete[] transactionIds;
+    delete[] senderAccounts;
+    delete[] receiverAccounts;
+    delete[] amountMicros;
+    delete[] typeCodes;
+    delete[] locationCodes;
+    delete[] channelCodes;
+    delete[] fraudBits;
+    transactionIds = senderAccounts = receiverAccounts = nullptr;
+    amountMicros = nullptr;
+    typeCodes = locationCodes = channelCodes = nullptr;
+    fraudBits = nullptr;
+    count = 0;
+    capacity = 0;
+}
+
+// Copies one column into a larger allocation
+template <typename T>
+static T *growColumn(T *column, long long count, long long newCapacity)
+{
+    T *grown = new T[newCapacity];
+    for (long long i = 0; i < count; i++)
+        grown[i] = column[i];
+    delete[] column;
+    return grown;
+}
+
+void TransactionTable::grow(long long minimumCapacity)
+{
+    long long newCapacity = capacity > 0 ? capacity : 4096;
+    while (newCapacity < minimumCapacity)
+        newCapacity *= 2;
+
+    transactionIds = growColumn(transactionIds, count, newCapacity);
+    senderAccounts = growColumn(senderAccounts, count, newCapacity);
+    receiverAccounts = growColumn(receiverAccounts, count, newCapacity);
+    amountMicros = growColumn(amountMicros, count, newCapacity);
+    typeCodes = growColumn(typeCodes, count, newCapacity);
+    locationCodes = growColumn(locationCodes, count, newCapacity);
+    channelCodes = growColumn(channelCodes, count, newCapacity);
+
+    // Capacity is always a multiple of 64, so the bitset words line up exactly
+    uint64_t *grownBits = new uint64_t[newCapacity / 64]();
+    if (fraudBits != nullptr)
+        memcpy(grownBits, fraudBits, (capacity / 64) * sizeof(uint64_t));
+    delete[] fraudBits;
+    fraudBits = grownBits;
+
+    capacity = newCapacity;
+}
+
+void TransactionTable::append(const Transaction &transaction)
+{
+    if (count == capacity)
+        grow(count + 1);
+
+    transactionIds[count] = transaction.getTransactionIDKey();
+    senderAccounts[count] = transaction.getSenderAccountKey();
+    receiverAccounts[count] = transaction.getReceiverAccountKey();
+    amountMicros[count] = transaction.getAmountMicros();
+    typeCodes[count] = transaction.getTransactionTypeCode();
+    locationCodes[count] = transaction.getLocationCode();
+    channelCodes[count] = transaction.getPaymentChannelCode();
+    if (transaction.getIsFraud())
+        fraudBits[count / 64] |= 1ull << (count % 64);
+    count++;
+}
+
+void TransactionTable::appendBatch(const Transaction batch[], int batchSize)
+{
+    if (count + batchSize > capacity)
+        grow(count + batchSize);
+    for (int i = 0; i < batchSize; i++)
+        append(batch[i]);
+}
+
+size_t TransactionTable::memoryUsage() const
+{
+    size_t perRow = 3 * sizeof(CompactId) + sizeof(int64_t) + 3 * sizeof(uint16_t);
+    return static_cast<size_t>(count) * perRow + static_cast<size_t>((count + 63) / 64) * sizeof(uint64_t);
+}
+
+Transaction TransactionTable::RowView::toTransaction() const
+{
+    Transaction transaction;
+    transaction.assignEncoded(table->transactionIds[row], table->senderAccounts[row], table->receiverAccounts[row],
+                              Amount::fromMicros(table->amountMicros[row]), table->typeCodes[row], table->locationCodes[row],
+                              table->channelCodes[row], table->getIsFraud(row));
+    return transaction;
+}
@@ -10,6 +10,7 @@
 #include "../include/DataStructureComparator.hpp"
 #include "../include/Transaction.hpp"
 #include "../include/CSVParser.hpp"
+#include "../include/TransactionBuffer.hpp"
 #include "../include/ArrayBasedCollection.hpp"
 #include "../include/LinkedListBasedCollection.hpp"
 
@@ -17,11 +18,12 @@ using namespace std;
 
 // --- Forward Declarations for Helper Functions ---
 
-// Handles the entire search process using the two-pass method
+// Handles the entire search process with a single filtered pass over the CSV
 void handleSearch(CSVParser &csvparser, string &searchKey);
 
-// Prompts user for exporting data to JSON (now takes a pointer and size)
-void askToExport(const Transaction *transactions, long long count, int exportLimit);
+// Prompts user for exporting data to JSON (now takes a pointer and size).
+// With an order, rows are exported in that sequence: transactions[order[0]], transactions[order[1]], ...
+void askToExport(const Transaction *transactions, long long count, int exportLimit, const uint32_t *order = nullptr);
 
 // Gets a valid search key from the user (no changes needed)
 string getSearchKeyFromUser(Transaction *firstPageTransactions, int firstPageSize);
@@ -40,6 +42,16 @@ int main()
         cout << "Error: No transactions found in the CSV file." << endl;
         return 1;
     }
+    // Convert the CSV to a binary columnar cache once; every search below then skips the text parse
+    if (!csvparser.hasFreshSnapshot())
+    {
+        cout << "Building columnar cache for faster searches..." << endl;
+        if (!csvparser.buildSnapshot())
+        {
+            cout << "Columnar cache unavailable, searches will parse the CSV directly." << endl;
+        }
+    }
+
     Transaction *firstPageTransactions = csvparser.getTransactions();
     int firstPageSize = csvparser.getNumTransactions();
 
@@ -87,32 +99,25 @@ int main()
 // --- Helper Function Implementations ---
 
 /**
- * @brief Handles the full search process using a two-pass approach to avoid std::vector.
+ * @brief Handles the full search process: one filtered scan, then processing of the matches.
  */
 void handleSearch(CSVParser &csvparser, string &searchKey)
 {
-    // --- 1. FIRST PASS: Count matching transactions ---
-    cout << "Pass 1: Counting matching transactions... Please wait." << endl;
-    if (!csvparser.initializeStreaming())
+    // --- 1. SINGLE PASS: Stream the file and keep only matching transactions ---
+    cout << "Scanning and loading matching transactions... Please wait." << endl;
+    TransactionBuffer matchingBuffer;
+    if (!csvparser.loadMatchingTransactions(searchKey, matchingBuffer))
     {
-        cout << "Failed to initialize streaming for counting." << endl;
+        cout << "Failed to initialize streaming for loading." << endl;
         return;
     }
 
-    long long matchingCount = 0;
-    long long totalProcessed = 0;
-    Transaction tempTransaction;
-    while (csvparser.getNextTransaction(tempTransaction))
-    {
-        totalProcessed++;
-        if (tempTransaction.getTransactionType() == searchKey)
-        {
-            matchingCount++;
-        }
-    }
-    csvparser.closeStream();
+    // Rows of other types are rejected by the parser before validation
+    const CSVParser::ParseStats &stats = csvparser.getParseStats();
+    long long totalScanned = stats.rowsExamined() + stats.filteredOut;
+    long long matchingCount = matchingBuffer.size();
 
-    cout << "Finished scanning " << totalProcessed << " rows." << endl;
+    cout << "Finished scanning " << totalScanned << " rows." << endl;
     cout << "Found " << matchingCount << " matching transactions for type '" << searchKey << "'." << endl;
 
     if (matchingCount == 0)
@@ -123,29 +128,8 @@ void handleSearch(CSVParser &csvparser, string &searchKey)
         return;
     }
 
-    // --- 2. Allocate memory and perform the SECOND PASS to populate the array ---
-    cout << "\nPass 2: Loading matching transactions into memory..." << endl;
-
-    // Allocate a single, perfectly sized dynamic array
-    Transaction *allMatchingArray = new Transaction[matchingCount];
-
-    if (!csvparser.initializeStreaming())
-    {
-        cout << "Failed to initialize streaming for populating." << endl;
-        delete[] allMatchingArray; // Clean up memory
-        return;
-    }
-
-    long long currentIndex = 0;
-    while (csvparser.getNextTransaction(tempTransaction) && currentIndex < matchingCount)
-    {
-        if (tempTransaction.getTransactionType() == searchKey)
-        {
-            allMatchingArray[currentIndex] = tempTransaction;
-            currentIndex++;
-        }
-    }
-    csvparser.closeStream();
+    // --- 2. Gather the matches into one contiguous array (rows are moved, not copied) ---
+    Transaction *allMatchingArray = matchingBuffer.moveToArray();
     cout << "Loading complete." << endl;
 
     // --- 3. Process collected data and measure performance ---
@@ -168,39 +152,33 @@ void handleSearch(CSVParser &csvparser, string &searchKey)
     finalComparator.setArraySortTime(arrayCollection.getSortTime().count() * 1000);     // Convert ms to μs
     cout << "Array processing completed." << endl;
 
+    // Linked list is built and processed one batch of rows at a time
     const int LL_BATCH_SIZE = 1000;
-    long long totalLinkedListTime = 0;
-    long long totalSearchTime = 0;
-    long long totalSortTime = 0;
-
-    for (long long i = 0; i < matchingCount; i += LL_BATCH_SIZE)
-    {
-        long long currentBatchSize = min((long long)LL_BATCH_SIZE, matchingCount - i);
-        Transaction *batch_ptr = &allMatchingArray[i];
-
-        auto llBatchStart = chrono::high_resolution_clock::now();
-
-        // Create LinkedListBasedCollection directly to get detailed timing
-        LinkedListBasedCollection batchLinkedList(searchKey, currentBatchSize, batch_ptr);
-        batchLinkedList.processSilently(searchKey);
-
-        auto llBatchEnd = chrono::high_resolution_clock::now(); // Accumulate all the timing metrics
-        totalLinkedListTime += chrono::duration_cast<chrono::microseconds>(llBatchEnd - llBatchStart).count();
-
-        // Get timing directly in microseconds (no conversion needed)
-        long long batchSearchTime = batchLinkedList.getSearchTime().count();
-        long long batchSortTime = batchLinkedList.getSortTime().count();
-
-        totalSearchTime += batchSearchTime;
-        totalSortTime += batchSortTime;
-    }
-
-    // Set the accumulated times in the final comparator
-    finalComparator.setLinkedListTime(totalLinkedListTime);
-    finalComparator.setLinkedListSearchTime(totalSearchTime);
-    finalComparator.setLinkedListSortTime(totalSortTime);
+    finalComparator.processLinkedListInBatches(LL_BATCH_SIZE);
     cout << "Linked List simulation completed." << endl;
 
+    // Same array algorithms over the struct-of-arrays column store
+    finalComparator.processTableStructureSilent();
+    cout << "Column table processing completed." << endl;
+
+    // Index sort that leaves the rows where they are, and the linear-time radix engine
+    finalComparator.processArraySortModeSilent(ArrayBasedCollection::SortMode::PERMUTATION,
+                                               ArrayBasedCollection::SortEngine::MERGE, "permutation");
+    finalComparator.processArraySortModeSilent(ArrayBasedCollection::SortMode::IN_PLACE,
+                                               ArrayBasedCollection::SortEngine::RADIX, "radix");
+    finalComparator.processArraySortModeSilent(ArrayBasedCollection::SortMode::PERMUTATION,
+                                               ArrayBasedCollection::SortEngine::RADIX, "permutation, radix");
+    // Merge sort spread over all cores
+    finalComparator.processArraySortModeSilent(ArrayBasedCollection::SortMode::IN_PLACE,
+                                               ArrayBasedCollection::SortEngine::PARALLEL_MERGE, "parallel merge");
+    // Bounded heaps that keep only the displayed rows of each channel
+    finalComparator.processArraySortModeSilent(ArrayBasedCollection::SortMode::TOP_K,
+                                               ArrayBasedCollection::SortEngine::MERGE, "top-k");
+    // Counting-sort partition by channel, one bucket per task
+    finalComparator.processArraySortModeSilent(ArrayBasedCollection::SortMode::BUCKETED,
+                                               ArrayBasedCollection::SortEngine::MERGE, "bucketed");
+    cout << "Permutation, radix, parallel, top-k and bucketed runs completed." << endl;
+
     arrayCollection.printGroupedByPaymentChannel(allMatchingArray, matchingCount, searchKey);
 
     // --- 4. Display Results ---
@@ -208,7 +186,9 @@ void handleSearch(CSVParser &csvparser, string &searchKey)
     finalComparator.displayFinalSummary();
 
     // --- 5. Export Option & Cleanup ---
-    askToExport(allMatchingArray, matchingCount, 10);
+    // In permutation mode the rows stay in input order and are exported through the sorted order
+    const uint32_t *exportOrder = arrayCollection.getOrder();
+    askToExport(allMatchingArray, exportOrder != nullptr ? arrayCollection.getOrderSize() : matchingCount, 10, exportOrder);
 
     // CRITICAL: Clean up the dynamically allocated memory
     delete[] allMatchingArray;
@@ -251,7 +231,7 @@ string getSearchKeyFromUser(Transaction *firstPageTransactions, int firstPageSiz
 /**
  * @brief Asks the user if they want to export results (using a raw pointer and count).
  */
-void askToExport(const Transaction *transactions, long long count, int exportLimit)
+void askToExport(const Transaction *transactions, long long count, int exportLimit, const uint32_t *order)
 {
     char exportChoice;
     while (true)
@@ -279,7 +259,7 @@ void askToExport(const Transaction *transactions, long long count, int exportLim
         {
             for (int i = 0; i < countToExport; ++i)
             {
-                j_array.push_back(transactions[i].to_json());
+                j_array.push_back(transactions[order != nullptr ? order[i] : i].to_json());
             }
             cout << "Top " << countToExport << " results exported." << endl;
         }
@@ -0,0 +1,129 @@
+#include "../include/CSVParser.hpp"
+#include "../include/TransactionBuffer.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace std;
+
+// Checks that parsing, constructing and buffering rows do no per-row heap allocation. Every
+// global operator new is counted; a field that starts owning heap memory again shows up as
+// about one allocation per row.
+
+static atomic<long long> allocationCount(0);
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    void *memory = malloc(size > 0 ? size : 1);
+    if (memory == nullptr)
+        throw bad_alloc();
+    return memory;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete[](void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+void operator delete[](void *memory, size_t) noexcept { free(memory); }
+
+static const char *CSV_PATH = "row_allocation_test.csv";
+static const int CSV_ROWS = 50000;
+static const int WARMUP_ROWS = 1000; // Long enough to see every dictionary value once
+
+static int failures = 0;
+
+static void check(bool condition, const string &what, long long allocations)
+{
+    cout << (condition ? "PASS " : "FAIL ") << what << ": " << allocations << " allocations" << endl;
+    if (!condition)
+        failures++;
+}
+
+// Same columns as the real dataset; the categorical fields cycle through small vocabularies
+static bool writeCsv()
+{
+    FILE *file = fopen(CSV_PATH, "w");
+    if (file == nullptr)
+        return false;
+
+    const char *types[] = {"withdrawal", "deposit", "transfer", "payment"};
+    const char *locations[] = {"Tokyo", "London", "Berlin", "Dubai", "Sydney"};
+    const char *channels[] = {"ACH", "card", "wire_transfer", "UPI"};
+    fprintf(file, "transaction_id,timestamp,sender_account,receiver_account,amount,transaction_type,"
+                  "merchant_category,location,device_used,is_fraud,fraud_type,time_since_last_transaction,"
+                  "spending_deviation_score,velocity_score,geo_anomaly_score,payment_channel,ip_address,"
+                  "device_hash\n");
+    for (int i = 0; i < CSV_ROWS; i++)
+    {
+        fprintf(file, "T%d,2023-08-22T09:22:43.516168,ACC%d,ACC%d,%d.%06d,%s,retail,%s,mobile,%s,,0.5,0.1,5,0.4,%s,"
+                      "13.101.214.112,D%d\n",
+                100000 + i, 100000 + i * 7 % 900000, 100000 + (i * 13 + 1) % 900000, 1 + i % 4999, i * 37 % 1000000,
+                types[i % 4], locations[i % 5], i % 3 == 0 ? "True" : "False", channels[i % 4], i);
+    }
+    return fclose(file) == 0;
+}
+
+int main()
+{
+    if (!writeCsv())
+    {
+        cerr << "Could not write " << CSV_PATH << endl;
+        return 1;
+    }
+
+    CSVParser parser;
+    parser.setFilePath(CSV_PATH);
+    if (!parser.initializeStreaming())
+    {
+        cerr << "Could not open " << CSV_PATH << endl;
+        remove(CSV_PATH);
+        return 1;
+    }
+
+    Transaction transaction;
+    long long rows = 0;
+    while (rows < WARMUP_ROWS && parser.getNextTransaction(transaction))
+        rows++;
+
+    long long before = allocationCount;
+    long long streamed = 0;
+    while (parser.getNextTransaction(transaction))
+        streamed++;
+    long long parseAllocations = allocationCount - before;
+    parser.closeStream();
+    check(streamed == CSV_ROWS - WARMUP_ROWS && parseAllocations == 0,
+          "getNextTransaction over " + to_string(streamed) + " rows", parseAllocations);
+
+    // One allocation per 4096-row chunk plus the chunk table as it doubles
+    TransactionBuffer buffer;
+    before = allocationCount;
+    for (int i = 0; i < CSV_ROWS; i++)
+        buffer.append(transaction);
+    long long bufferAllocations = allocationCount - before;
+    check(bufferAllocations <= CSV_ROWS / 4096 + 1 + 16, "TransactionBuffer::append x" + to_string(CSV_ROWS),
+          bufferAllocations);
+
+    before = allocationCount;
+    Transaction *rowsArray = buffer.moveToArray();
+    long long moveAllocations = allocationCount - before;
+    check(moveAllocations == 1, "TransactionBuffer::moveToArray", moveAllocations);
+
+    // The first construction may add its values to the dictionaries
+    rowsArray[0] = Transaction("TXN_123456", "ACC123", "ACC456", 12.5, "payment", "Tokyo", "card", false);
+    before = allocationCount;
+    for (int i = 0; i < CSV_ROWS; i++)
+        rowsArray[i] = Transaction("TXN_123456", "ACC123", "ACC456", 12.5, "payment", "Tokyo", "card", false);
+    long long constructAllocations = allocationCount - before;
+    check(constructAllocations == 0, "Transaction(string_view...) x" + to_string(CSV_ROWS), constructAllocations);
+
+    delete[] rowsArray;
+    remove(CSV_PATH);
+    return failures == 0 ? 0 : 1;
+}